@@ -803,10 +803,14 @@ int8_t bmp3_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, struct b
     if ((rslt == BMP3_OK) && (reg_data != NULL))
     {
         uint32_t temp_len = len + dev->dummy_byte;
-        uint8_t temp_buff[len + dev->dummy_byte];
+        uint8_t temp_buff[BMP3_MAX_SPI_READ_LEN + 1];
 
         /* If interface selected is SPI */
-        if (dev->intf != BMP3_I2C_INTF)
+        if ((dev->intf != BMP3_I2C_INTF) && (len > BMP3_MAX_SPI_READ_LEN))
+        {
+            rslt = BMP3_E_INVALID_LEN;
+        }
+        else if (dev->intf != BMP3_I2C_INTF)
         {
             reg_addr = reg_addr | 0x80;
 
@@ -824,7 +828,7 @@ int8_t bmp3_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, struct b
         }
 
         /* Check for communication error */
-        if (dev->intf_rslt != BMP3_INTF_RET_SUCCESS)
+        if ((rslt == BMP3_OK) && (dev->intf_rslt != BMP3_INTF_RET_SUCCESS))
         {
             rslt = BMP3_E_COMM_FAIL;
         }
@@ -844,7 +848,7 @@ int8_t bmp3_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, struct b
 int8_t bmp3_set_regs(uint8_t *reg_addr, const uint8_t *reg_data, uint32_t len, struct bmp3_dev *dev)
 {
     int8_t rslt;
-    uint8_t temp_buff[len * 2];
+    uint8_t temp_buff[BMP3_MAX_BURST_WRITE_REGS * 2];
     uint32_t temp_len;
     uint8_t reg_addr_cnt;
 
@@ -854,7 +858,11 @@ int8_t bmp3_set_regs(uint8_t *reg_addr, const uint8_t *reg_data, uint32_t len, s
     /* Check for arguments validity */
     if ((rslt == BMP3_OK) && (reg_addr != NULL) && (reg_data != NULL))
     {
-        if (len != 0)
+        if (len > BMP3_MAX_BURST_WRITE_REGS)
+        {
+            rslt = BMP3_E_INVALID_LEN;
+        }
+        else if (len != 0)
         {
             temp_buff[0] = reg_data[0];
 
@@ -1432,7 +1440,6 @@ int8_t bmp3_get_sensor_data(uint8_t sensor_comp, struct bmp3_data *comp_data, st
     /* Array to store the pressure and temperature data read from
      * the sensor */
     uint8_t reg_data[BMP3_LEN_P_T_DATA] = { 0 };
-    struct bmp3_uncomp_data uncomp_data = { 0 };
 
     if (comp_data != NULL)
     {
@@ -1441,12 +1448,7 @@ int8_t bmp3_get_sensor_data(uint8_t sensor_comp, struct bmp3_data *comp_data, st
 
         if (rslt == BMP3_OK)
         {
-            /* Parse the read data from the sensor */
-            parse_sensor_data(reg_data, &uncomp_data);
-
-            /* Compensate the pressure/temperature/both data read
-             * from the sensor */
-            rslt = compensate_data(sensor_comp, &uncomp_data, comp_data, &dev->calib_data);
+            rslt = bmp3_compensate_sensor_data(sensor_comp, reg_data, comp_data, dev);
         }
     }
     else
@@ -1457,6 +1459,36 @@ int8_t bmp3_get_sensor_data(uint8_t sensor_comp, struct bmp3_data *comp_data, st
     return rslt;
 }
 
+/*!
+ * @brief This API compensates pressure and temperature data registers that
+ * were read by the caller (local change: lets the data registers be read in
+ * one burst with the status and sensor time registers).
+ */
+int8_t bmp3_compensate_sensor_data(uint8_t sensor_comp,
+                                   const uint8_t *reg_data,
+                                   struct bmp3_data *comp_data,
+                                   struct bmp3_dev *dev)
+{
+    int8_t rslt;
+    struct bmp3_uncomp_data uncomp_data = { 0 };
+
+    if ((reg_data != NULL) && (comp_data != NULL) && (dev != NULL))
+    {
+        /* Parse the read data from the sensor */
+        parse_sensor_data(reg_data, &uncomp_data);
+
+        /* Compensate the pressure/temperature/both data read
+         * from the sensor */
+        rslt = compensate_data(sensor_comp, &uncomp_data, comp_data, &dev->calib_data);
+    }
+    else
+    {
+        rslt = BMP3_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
 /****************** Static Function Definitions *******************************/
 
 /*!
@@ -277,6 +277,32 @@ int8_t bmp3_get_op_mode(uint8_t *op_mode, struct bmp3_dev *dev);
  */
 int8_t bmp3_get_sensor_data(uint8_t sensor_comp, struct bmp3_data *data, struct bmp3_dev *dev);
 
+/*!
+ * \ingroup bmp3ApiData
+ * \page bmp3_api_bmp3_compensate_sensor_data bmp3_compensate_sensor_data
+ * \code
+ * int8_t bmp3_compensate_sensor_data(uint8_t sensor_comp, const uint8_t *reg_data,
+ *                                    struct bmp3_data *data, struct bmp3_dev *dev);
+ * \endcode
+ * @details This API compensates pressure, temperature or both from data
+ * registers the caller has already read (local change). reg_data holds the
+ * BMP3_LEN_P_T_DATA bytes starting at BMP3_REG_DATA.
+ *
+ * @param[in] sensor_comp : BMP3_PRESS, BMP3_TEMP or BMP3_PRESS_TEMP.
+ * @param[in] reg_data    : Raw data registers.
+ * @param[out] data       : Structure instance of bmp3_data.
+ * @param[in] dev         : Structure instance of bmp3_dev (calibration).
+ *
+ * @return Result of API execution status
+ * @retval 0  -> Success
+ * @retval >0 -> Warning
+ * @retval <0 -> Error
+ */
+int8_t bmp3_compensate_sensor_data(uint8_t sensor_comp,
+                                   const uint8_t *reg_data,
+                                   struct bmp3_data *data,
+                                   struct bmp3_dev *dev);
+
 /**
  * \ingroup bmp3
  * \defgroup bmp3ApiRegs Registers
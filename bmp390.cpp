@@ -1,37 +1,90 @@
 // (C) Alan Ludwig 2026, all rights reserved.
 
 #include "bmp390.h"
+#include "logger.h"
+#include "probe.h"
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include <cmath>
 #include <cstring>
-#include <cstdio>
 
 extern "C" {
 #include "bmp3.h"
 }
+#include "sensorconfig.h"
 
 namespace bmp390 {
 
-// Structure to hold I2C instance and address for callbacks
-struct I2CContext {
-    i2c_inst_t* i2c;
-    uint8_t address;
+// Register settings for each Profile, checked and encoded at compile time.
+// Note: ODR must be compatible with oversampling settings
+// Standard: ~100ms updates
+using StandardConfig = sensorconfig::SensorConfig<BMP3_OVERSAMPLING_4X, BMP3_OVERSAMPLING_2X,
+                                                  BMP3_ODR_12_5_HZ, BMP3_IIR_FILTER_COEFF_3>;
+// HighRate: 20ms updates for fast altitude changes
+using HighRateConfig = sensorconfig::SensorConfig<BMP3_OVERSAMPLING_2X, BMP3_NO_OVERSAMPLING,
+                                                  BMP3_ODR_50_HZ, BMP3_IIR_FILTER_COEFF_1>;
+// LowPower: slow updates for long-term pressure tracking
+using LowPowerConfig = sensorconfig::SensorConfig<BMP3_NO_OVERSAMPLING, BMP3_NO_OVERSAMPLING,
+                                                  BMP3_ODR_1_5_HZ, BMP3_IIR_FILTER_DISABLE>;
+
+static constexpr sensorconfig::RegisterImage PROFILES[] = {
+    StandardConfig::IMAGE,
+    HighRateConfig::IMAGE,
+    LowPowerConfig::IMAGE,
 };
+static_assert(sizeof(PROFILES) / sizeof(PROFILES[0]) == static_cast<size_t>(Profile::Count),
+              "PROFILES must have one entry per Profile");
+
+uint32_t outputPeriodUs(Profile profile) {
+    size_t index = static_cast<size_t>(profile) < static_cast<size_t>(Profile::Count)
+                       ? static_cast<size_t>(profile) : static_cast<size_t>(Profile::Standard);
+    return PROFILES[index].periodUs;
+}
+
+// One burst covers status (0x03), pressure and temperature (0x04-0x09), two
+// reserved bytes and sensor time (0x0C-0x0E, 24 bits little endian). The
+// sensor shadows the data registers for the length of a burst, so the sample
+// and its timestamp belong together.
+constexpr uint8_t BURST_START = BMP3_REG_SENS_STATUS;
+constexpr uint8_t REG_SENSOR_TIME = 0x0C;
+constexpr uint32_t BURST_LEN = REG_SENSOR_TIME + 3 - BURST_START;
+constexpr uint32_t DATA_OFFSET = BMP3_REG_DATA - BURST_START;
+constexpr uint32_t TIME_OFFSET = REG_SENSOR_TIME - BURST_START;
+static_assert(BURST_LEN <= BMP3_MAX_SPI_READ_LEN, "the data burst must fit the driver's read buffer");
+
+// Transfers are bounded so a device holding the bus low cannot hang the
+// caller: a fixed allowance plus the time for each byte at 100 kHz
+constexpr uint I2C_TIMEOUT_BASE_US = 1000;
+constexpr uint I2C_TIMEOUT_PER_BYTE_US = 200;
+
+// Longest write the driver makes: an interleaved burst of register and data
+// byte pairs
+constexpr uint32_t MAX_WRITE_LEN = 2 * BMP3_MAX_BURST_WRITE_REGS;
+static_assert(2 * sensorconfig::BURST_LENGTH <= MAX_WRITE_LEN, "the settings burst must fit one write");
+
+static uint transferTimeoutUs(size_t len) {
+    return I2C_TIMEOUT_BASE_US + static_cast<uint>(len) * I2C_TIMEOUT_PER_BYTE_US;
+}
+
+// Record a transfer's result, returns true if it succeeded
+static bool checkTransfer(I2CContext* ctx, int result) {
+    ctx->lastError = result < 0 ? result : PICO_OK;
+    return result >= 0;
+}
 
 // I2C read callback for BMP3 API
 static BMP3_INTF_RET_TYPE i2c_read(uint8_t reg_addr, uint8_t *read_data, uint32_t len, void *intf_ptr) {
     I2CContext* ctx = static_cast<I2CContext*>(intf_ptr);
     
     // Write register address
-    int result = i2c_write_blocking(ctx->i2c, ctx->address, &reg_addr, 1, true);
-    if (result < 0) {
+    int result = i2c_write_timeout_us(ctx->i2c, ctx->address, &reg_addr, 1, true, transferTimeoutUs(1));
+    if (!checkTransfer(ctx, result)) {
         return BMP3_E_COMM_FAIL;
     }
     
     // Read data
-    result = i2c_read_blocking(ctx->i2c, ctx->address, read_data, len, false);
-    if (result < 0) {
+    result = i2c_read_timeout_us(ctx->i2c, ctx->address, read_data, len, false, transferTimeoutUs(len));
+    if (!checkTransfer(ctx, result)) {
         return BMP3_E_COMM_FAIL;
     }
     
@@ -43,12 +96,16 @@ static BMP3_INTF_RET_TYPE i2c_write(uint8_t reg_addr, const uint8_t *write_data,
     I2CContext* ctx = static_cast<I2CContext*>(intf_ptr);
     
     // Create buffer with register address followed by data
-    uint8_t buffer[len + 1];
+    uint8_t buffer[MAX_WRITE_LEN + 1];
+    if (len > MAX_WRITE_LEN) {
+        return BMP3_E_COMM_FAIL;
+    }
     buffer[0] = reg_addr;
     memcpy(buffer + 1, write_data, len);
     
-    int result = i2c_write_blocking(ctx->i2c, ctx->address, buffer, len + 1, false);
-    if (result < 0) {
+    int result = i2c_write_timeout_us(ctx->i2c, ctx->address, buffer, len + 1, false,
+                                      transferTimeoutUs(len + 1));
+    if (!checkTransfer(ctx, result)) {
         return BMP3_E_COMM_FAIL;
     }
     
@@ -62,22 +119,27 @@ static void delay_us(uint32_t period, void *intf_ptr) {
 }
 
 BMP390::BMP390(i2c_inst_t* i2c, uint8_t address) 
-    : i2c(i2c), i2cAddress(address), temperature(0.0), pressure(0.0), 
-      seaLevelPressurePa(101325.0), dev(nullptr) {
+    : i2c(i2c), i2cAddress(address), profile(Profile::Standard), reading(Reading{0.0, 0.0, 0}),
+      sensorTime(0), fresh(false), clock(), phase(), stamped(false), seaLevelPressurePa(101325.0), context{i2c, address, PICO_OK}, device(), ready(false) {
 }
 
-bool BMP390::begin() {
-    printf("BMP390::begin() - Initializing at address 0x%02X\n", i2cAddress);
-    
-    // Allocate BMP3 device structure and I2C context
-    bmp3_dev* bmp3 = new bmp3_dev();
-    I2CContext* ctx = new I2CContext{i2c, i2cAddress};
-    
-    memset(bmp3, 0, sizeof(bmp3_dev));
+bool BMP390::begin(Profile requestedProfile) {
+    if (static_cast<size_t>(requestedProfile) >= static_cast<size_t>(Profile::Count)) {
+        requestedProfile = Profile::Standard;
+    }
+    profile = requestedProfile;
+
+    logger::log(logger::Msg::SensorBegin, i2cAddress);
+
+    // Start over from a clean device structure (this may be a re-init)
+    ready = false;
+    device = bmp3_dev();
+    context.lastError = PICO_OK;
+    bmp3_dev* bmp3 = &device;
     
     // Configure the device structure
     bmp3->intf = BMP3_I2C_INTF;
-    bmp3->intf_ptr = ctx;
+    bmp3->intf_ptr = &context;
     bmp3->read = i2c_read;
     bmp3->write = i2c_write;
     bmp3->delay_us = delay_us;
@@ -85,75 +147,91 @@ bool BMP390::begin() {
     // Initialize the sensor
     int8_t rslt = bmp3_init(bmp3);
     if (rslt != BMP3_OK) {
-        printf("BMP390: bmp3_init failed with error %d\n", rslt);
-        printf("  Chip ID read: 0x%02X (expected 0x50 for BMP388 or 0x60 for BMP390)\n", bmp3->chip_id);
-        delete ctx;
-        delete bmp3;
+        logger::log(logger::Msg::SensorInitFailed, rslt);
+        logger::log(logger::Msg::SensorChipIdRead, bmp3->chip_id);
         return false;
     }
     
-    printf("BMP390: Chip ID = 0x%02X\n", bmp3->chip_id);
-    
-    // Configure sensor settings
-    // Note: ODR must be compatible with oversampling settings
-    // With 4x press OS and 2x temp OS, using 12.5Hz for ~100ms updates
-    bmp3_settings settings = {};
-    settings.press_en = BMP3_ENABLE;
-    settings.temp_en = BMP3_ENABLE;
-    settings.odr_filter.press_os = BMP3_OVERSAMPLING_4X;
-    settings.odr_filter.temp_os = BMP3_OVERSAMPLING_2X;
-    settings.odr_filter.odr = BMP3_ODR_12_5_HZ;
-    settings.odr_filter.iir_filter = BMP3_IIR_FILTER_COEFF_3;
+    logger::log(logger::Msg::SensorChipId, bmp3->chip_id);
     
-    uint32_t settings_sel = BMP3_SEL_PRESS_EN | BMP3_SEL_TEMP_EN | 
-                            BMP3_SEL_PRESS_OS | BMP3_SEL_TEMP_OS | 
-                            BMP3_SEL_ODR | BMP3_SEL_IIR_FILTER;
-    
-    rslt = bmp3_set_sensor_settings(settings_sel, &settings, bmp3);
+    // Apply the profile's register image in one burst write. The power
+    // control byte goes last and starts normal mode.
+    const sensorconfig::RegisterImage& image = PROFILES[static_cast<size_t>(profile)];
+    uint8_t registers[sensorconfig::BURST_LENGTH];
+    memcpy(registers, sensorconfig::BURST_REGISTERS, sizeof(registers));
+    const uint8_t values[sensorconfig::BURST_LENGTH] = {image.osr, image.odr, image.config, image.pwrCtrl};
+    rslt = bmp3_set_regs(registers, values, sensorconfig::BURST_LENGTH, bmp3);
     if (rslt != BMP3_OK) {
-        printf("BMP390: bmp3_set_sensor_settings failed with error %d\n", rslt);
-        delete ctx;
-        delete bmp3;
+        logger::log(logger::Msg::SensorSettingsFailed, rslt);
         return false;
     }
-    
-    // Set to normal mode
-    settings.op_mode = BMP3_MODE_NORMAL;
-    rslt = bmp3_set_op_mode(&settings, bmp3);
-    if (rslt != BMP3_OK) {
-        printf("BMP390: bmp3_set_op_mode failed with error %d\n", rslt);
-        delete ctx;
-        delete bmp3;
+
+    // The settings were checked at compile time, but confirm the sensor
+    // took them (a wrong chip or a reset in between would show here)
+    uint8_t error = 0;
+    rslt = bmp3_get_regs(BMP3_REG_ERR, &error, 1, bmp3);
+    if (rslt != BMP3_OK || (error & BMP3_ERR_CONF)) {
+        logger::log(logger::Msg::SensorOpModeFailed, rslt != BMP3_OK ? rslt : BMP3_E_CONFIGURATION_ERR);
         return false;
     }
     
-    printf("BMP390: Initialized successfully!\n");
-    dev = bmp3;
+    logger::log(logger::Msg::SensorInitialized);
+    ready = true;
+    sensorTime = 0;
+    fresh = false;
+    clock.reset();
+    phase.reset(static_cast<uint32_t>(static_cast<uint64_t>(image.periodUs) * sensortime::TICKS_PER_SECOND / 1000000));
+    stamped = false;
     return true;
 }
 
 bool BMP390::readSensor() {
-    if (!dev) {
+    if (!ready) {
         return false;
     }
     
-    bmp3_dev* bmp3 = static_cast<bmp3_dev*>(dev);
+    bmp3_dev* bmp3 = &device;
+    uint8_t burst[BURST_LEN];
+    uint64_t startUs = time_us_64();
+    int8_t rslt = bmp3_get_regs(BURST_START, burst, BURST_LEN, bmp3);
+    uint64_t endUs = time_us_64();
+    probe::mark(probe::Stage::Read);
+    if (rslt != BMP3_OK) {
+        logger::log(logger::Msg::SensorReadError, rslt);
+        return false;
+    }
+
     bmp3_data data = {};
-    
-    int8_t rslt = bmp3_get_sensor_data(BMP3_PRESS_TEMP, &data, bmp3);
+    rslt = bmp3_compensate_sensor_data(BMP3_PRESS_TEMP, &burst[DATA_OFFSET], &data, bmp3);
     if (rslt != BMP3_OK) {
+        logger::log(logger::Msg::SensorReadError, rslt);
         return false;
     }
-    
-    temperature = data.temperature;
-    pressure = data.pressure;
-    
+
+    // The middle of the transfer is the best MCU-side estimate of when the
+    // sensor time was captured
+    sensorTime = burst[TIME_OFFSET] | (static_cast<uint32_t>(burst[TIME_OFFSET + 1]) << 8) |
+                 (static_cast<uint32_t>(burst[TIME_OFFSET + 2]) << 16);
+    uint64_t ticks = clock.update(sensorTime, startUs + (endUs - startUs) / 2);
+    fresh = (burst[0] & (BMP3_DRDY_PRESS | BMP3_DRDY_TEMP)) == (BMP3_DRDY_PRESS | BMP3_DRDY_TEMP);
+
+    // The sensor time is when the read ran; the data is from the last
+    // conversion, up to a period before. Date it by the conversions' phase,
+    // which the data ready flags narrow down read by read. A read that found
+    // no new data returns the last sample again, so it keeps that one's time.
+    phase.update(ticks, fresh);
+    uint64_t timeUs = fresh || !stamped ? clock.toMcuUs(phase.getReadyTicks()) : reading.load().timeUs;
+    stamped = true;
+
+    reading.store(Reading{data.pressure, data.temperature, timeUs});
+    probe::mark(probe::Stage::Compensate);
     return true;
 }
 
 double BMP390::getAltitudeMeters(double seaLevelPressure) const {
     // International barometric formula
     // altitude = 44330 * (1 - (P/P0)^(1/5.255))
+    double pressure = reading.load().pressure;
     if (pressure <= 0 || seaLevelPressure <= 0) {
         return 0.0;
     }
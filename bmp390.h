@@ -3,26 +3,92 @@
 #pragma once
 
 #include <cstdint>
+#include "bmp3_defs.h"
+#include "phaselock.h"
+#include "sampling.h"
+#include "sensortime.h"
+#include "seqlock.h"
 
 typedef struct i2c_inst i2c_inst_t;
 
 namespace bmp390 {
 
-class BMP390 {
+// Acquisition profiles: oversampling, output data rate and IIR filter
+enum class Profile : uint8_t {
+    Standard = 0,   // 4x pressure, 2x temperature, 12.5 Hz, IIR 3
+    HighRate,       // 2x pressure, 1x temperature, 50 Hz, IIR 1
+    LowPower,       // 1x pressure, 1x temperature, 1.5 Hz, no IIR
+    Count
+};
+
+// Output data period of a profile: how often a new sample is ready
+uint32_t outputPeriodUs(Profile profile);
+
+// Bus and address handed to the BMP3 driver's transfer callbacks
+struct I2CContext {
+    i2c_inst_t* i2c;
+    uint8_t address;
+    int lastError;      // PICO_OK or the last failed transfer's error
+};
+
+// One compensated sample
+struct Reading {
+    double pressure;     // Pascals
+    double temperature;  // Celsius
+    uint64_t timeUs;     // When its conversion finished, on the MCU clock (us since boot)
+};
+
+class BMP390 : public sampling::Source {
 public:
     BMP390(i2c_inst_t* i2c, uint8_t address = 0x77);
     
-    // Initialize the sensor, returns true on success
-    bool begin();
+    // Initialize the sensor, returns true on success. May be called again to
+    // re-initialize a sensor that has stopped responding.
+    bool begin(Profile profile = Profile::Standard);
+
+    Profile getProfile() const { return profile; }
+    uint8_t getAddress() const { return i2cAddress; }
     
-    // Read sensor data
-    bool readSensor();
+    // Read status, pressure, temperature and sensor time in one burst
+    bool readSensor() override;
     
     // Get the last read temperature in degrees Celsius
-    double getTemperature() const { return temperature; }
+    double getTemperature() const override { return reading.load().temperature; }
     
     // Get the last read pressure in Pascals
-    double getPressure() const { return pressure; }
+    double getPressure() const override { return reading.load().pressure; }
+
+    // When the last sample's conversion finished, on the MCU clock
+    uint64_t getSampleTimeUs() const override { return reading.load().timeUs; }
+
+    // Get the last sample as a consistent pair (safe from either core)
+    Reading getReading() const { return reading.load(); }
+
+    // Sensor time (24-bit, 25.6 kHz) read with the last sample. It advances
+    // while the sensor is converting, so a value that stops changing means
+    // the sensor has stalled or reset into sleep mode.
+    uint32_t getSensorTime() const { return sensorTime; }
+
+    // Sensor time of the last sample unwrapped to 64 bits (25.6 kHz ticks;
+    // unwrapping starts again at begin())
+    uint64_t getSensorTicks() const { return clock.getTicks(); }
+
+    // MCU time (us since boot) of an unwrapped sensor tick count, and the
+    // length of a tick on the MCU clock
+    uint64_t toMcuUs(uint64_t ticks) const { return clock.toMcuUs(ticks); }
+    double getUsPerTick() const { return clock.getUsPerTick(); }
+
+    // True if the last read found new pressure and temperature data (the
+    // data ready flags clear when the data registers are read)
+    bool isFresh() const { return fresh; }
+
+    // The conversions' phase as the reads since begin() have narrowed it
+    // down. Dates the samples, and tells when to read for the newest data.
+    const phaselock::PhaseLock& getPhaseLock() const { return phase; }
+
+    // Pico SDK error from the last failed bus transfer (PICO_ERROR_TIMEOUT
+    // when the bus is stuck), PICO_OK once a transfer succeeds
+    int getLastBusError() const { return context.lastError; }
     
     // Calculate altitude from pressure using the barometric formula
     // seaLevelPressure should be in Pascals (default 101325 Pa = 1013.25 hPa)
@@ -33,6 +99,7 @@ public:
     
     // Set the reference sea level pressure for altitude calculations
     void setSeaLevelPressure(double pressure) { seaLevelPressurePa = pressure; }
+    double getSeaLevelPressure() const { return seaLevelPressurePa; }
     
     // Get altitude using stored sea level pressure (101325 Pa default)
     double getAltitudeMeters() const { return getAltitudeMeters(seaLevelPressurePa); }
@@ -41,12 +108,21 @@ public:
 private:
     i2c_inst_t* i2c;
     uint8_t i2cAddress;
-    double temperature;  // Celsius
-    double pressure;     // Pascals
+    Profile profile;
+    seqlock::SeqLock<Reading> reading;
+    uint32_t sensorTime;
+    bool fresh;
+    sensortime::Clock clock;    // Sensor time to MCU time
+    phaselock::PhaseLock phase; // When new data is ready, in sensor time
+    bool stamped;               // A sample has been dated since begin()
     double seaLevelPressurePa;
-    
-    // Opaque pointer to BMP3 device structure
-    void* dev;
+
+    // Driver state, owned here so nothing is allocated. The driver keeps a
+    // pointer to context, so a BMP390 cannot be copied or moved (the seqlock
+    // member already prevents it).
+    I2CContext context;
+    bmp3_dev device;
+    bool ready;         // begin() succeeded
 };
 
 }  // namespace bmp390
@@ -124,6 +124,15 @@ extern "C" {
 #define BMP3_INTF_RET_SUCCESS                   INT8_C(0)
 #endif
 
+/**\name Transfer buffer bounds (local change: fixed-size buffers replace the
+ * variable length arrays in bmp3_get_regs and bmp3_set_regs) */
+#ifndef BMP3_MAX_BURST_WRITE_REGS
+#define BMP3_MAX_BURST_WRITE_REGS               UINT8_C(8)
+#endif
+#ifndef BMP3_MAX_SPI_READ_LEN
+#define BMP3_MAX_SPI_READ_LEN                   UINT8_C(32)
+#endif
+
 /**\name I2C addresses */
 #define BMP3_ADDR_I2C_PRIM                      UINT8_C(0x76)
 #define BMP3_ADDR_I2C_SEC                       UINT8_C(0x77)
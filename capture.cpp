@@ -0,0 +1,112 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "capture.h"
+
+namespace capture {
+
+// Millisecond times wrap after 49 days; compare them by difference
+static bool after(uint32_t timeMs, uint32_t referenceMs) {
+    return static_cast<int32_t>(timeMs - referenceMs) > 0;
+}
+
+const char* findTrigger(const pipeline::Output& output, bool wasValid) {
+    static const char* const EVENTS[] = {nullptr, "launch", "apogee", "landing"};
+    if (!output.valid) {
+        return wasValid ? "sensor fault" : nullptr;
+    }
+    if (output.flightEvent != flightevents::Event::None) {
+        return EVENTS[static_cast<size_t>(output.flightEvent)];
+    }
+    if (output.verticalFeetPerMinute < RAPID_DESCENT_FPM) {
+        return "rapid descent";
+    }
+    return nullptr;
+}
+
+Capture::Capture(uint32_t preMs, uint32_t postMs)
+    : preMs(preMs), postMs(postMs), ring(), written(0), flushSequence(0), endSequence(0),
+      capturing(false), startMs(0), endMs(0), captures(0), flushed(0), overruns(0) {}
+
+void Capture::setWindows(uint32_t pre, uint32_t post) {
+    preMs = pre;
+    postMs = post;
+}
+
+void Capture::add(const logformat::Record& record) {
+    // The post window closes at endMs, or at time going backwards (a new
+    // recording)
+    if (capturing && (after(record.timeMs, endMs) || after(at(written - 1).timeMs, record.timeMs))) {
+        capturing = false;
+    }
+    // The slot to be written next holds the oldest unflushed sample
+    if (flushSequence != endSequence && written - flushSequence >= RING_RECORDS) {
+        overruns++;
+        return;
+    }
+    ring[written % RING_RECORDS] = record;
+    written++;
+    if (capturing) {
+        endSequence = written;
+    }
+}
+
+bool Capture::trigger(uint32_t timeMs) {
+    bool flushing = flushSequence != endSequence;
+    if (capturing || flushing) {
+        // Continue the capture under way, up to its limit
+        uint32_t limitMs = startMs + MAX_CAPTURE_MS;
+        uint32_t untilMs = after(timeMs + postMs, limitMs) ? limitMs : timeMs + postMs;
+        if (capturing) {
+            if (after(untilMs, endMs)) {
+                endMs = untilMs;
+            }
+            return false;
+        }
+        // Flushing a capture already at its limit: nothing to continue
+        if (!after(untilMs, timeMs)) {
+            return false;
+        }
+        endSequence = written;
+        capturing = true;
+        endMs = untilMs;
+        return false;
+    }
+
+    // Walk back over the pre-trigger window, stopping at the oldest sample
+    // still held, at the end of the last capture (endSequence, already
+    // flushed) or at time going backwards (a new recording)
+    uint32_t held = written < RING_RECORDS ? written : RING_RECORDS;
+    uint32_t windowMs = timeMs - preMs;
+    uint32_t start = written;
+    uint32_t laterMs = timeMs;
+    while (written - start < held && start != endSequence) {
+        uint32_t sampleMs = at(start - 1).timeMs;
+        if (after(windowMs, sampleMs) || after(sampleMs, laterMs)) {
+            break;
+        }
+        laterMs = sampleMs;
+        start--;
+    }
+    flushSequence = start;
+    endSequence = written;
+    capturing = true;
+    startMs = timeMs;
+    endMs = timeMs + postMs;
+    captures++;
+    return true;
+}
+
+bool Capture::service(Sink sink) {
+    for (size_t i = 0; i < FLUSH_PER_SERVICE && flushSequence != endSequence; ++i) {
+        logformat::Record record = at(flushSequence);
+        record.flags |= logformat::RECORD_CAPTURE;
+        if (!sink(record)) {
+            return false;
+        }
+        flushSequence++;
+        flushed++;
+    }
+    return flushSequence != endSequence;
+}
+
+}  // namespace capture
@@ -0,0 +1,96 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "logformat.h"
+#include "pipeline.h"
+
+// Full-rate capture around events. Every sample goes into a RAM ring; a
+// trigger freezes the samples from the pre-trigger window before it and
+// keeps those of the post-trigger window after it, and service() hands them
+// to a sink (the flight log) a few at a time in the background. Regular
+// logging carries on at its own rate meanwhile, so full resolution is kept
+// only where something happened. No SDK dependencies.
+namespace capture {
+
+// 1024 samples is 20 s at 50 Hz (12 KB of RAM)
+constexpr size_t RING_RECORDS = 1024;
+
+constexpr uint32_t DEFAULT_PRE_MS = 5000;
+constexpr uint32_t DEFAULT_POST_MS = 10000;
+
+// Sinking faster than this triggers a capture (50 ft/s; a parachute descent
+// is slower, a ballistic or spiralling one is not)
+constexpr double RAPID_DESCENT_FPM = -3000.0;
+
+// Triggers extend one capture's post window to at most this long after the
+// trigger that started it, so a condition that keeps firing (a long fast
+// descent) cannot keep streaming to flash
+constexpr uint32_t MAX_CAPTURE_MS = 60000;
+
+// Samples handed to the sink per service() call
+constexpr size_t FLUSH_PER_SERVICE = 16;
+
+// Takes one sample; returns false to be offered it again later
+using Sink = bool (*)(const logformat::Record& record);
+
+// What in a pipeline output is worth a capture: a sensor fault (only as the
+// sensor goes from valid to invalid; wasValid is the previous output's), a
+// flight event or a rapid descent. Returns its name, or nullptr.
+const char* findTrigger(const pipeline::Output& output, bool wasValid);
+
+class Capture {
+public:
+    Capture(uint32_t preMs = DEFAULT_PRE_MS, uint32_t postMs = DEFAULT_POST_MS);
+
+    // Windows for the next trigger. Pre-trigger history is limited by the
+    // ring (at most RING_RECORDS samples) and by the last capture: no sample
+    // is captured twice.
+    void setWindows(uint32_t preMs, uint32_t postMs);
+
+    // Add a sample. While a capture is being flushed its samples are never
+    // overwritten; if the ring is full of them the new sample is dropped
+    // from the ring (and counted), not from regular logging.
+    void add(const logformat::Record& record);
+
+    // Something happened at timeMs. Starts a capture, or extends the post
+    // window of the one under way; a trigger while the last capture is
+    // still being flushed continues it. Neither goes past MAX_CAPTURE_MS
+    // from the start. Returns true if a capture started.
+    bool trigger(uint32_t timeMs);
+
+    // Hand up to FLUSH_PER_SERVICE captured samples to the sink, with
+    // RECORD_CAPTURE set. Returns true if more are ready now.
+    bool service(Sink sink);
+
+    // A post window is open or captured samples are waiting for the sink
+    bool isActive() const { return capturing || flushSequence != endSequence; }
+
+    uint32_t getCaptureCount() const { return captures; }
+    uint32_t getFlushedCount() const { return flushed; }
+    uint32_t getOverrunCount() const { return overruns; }
+
+private:
+    const logformat::Record& at(uint32_t sequence) const { return ring[sequence % RING_RECORDS]; }
+
+    uint32_t preMs;
+    uint32_t postMs;
+
+    // Samples are numbered in the order added; the ring holds the newest
+    // RING_RECORDS of them. Captured samples are flushSequence up to (not
+    // including) endSequence.
+    logformat::Record ring[RING_RECORDS];
+    uint32_t written;
+    uint32_t flushSequence;
+    uint32_t endSequence;
+    bool capturing;             // Post window open until endMs
+    uint32_t startMs;           // Trigger that started the capture
+    uint32_t endMs;
+
+    uint32_t captures;
+    uint32_t flushed;
+    uint32_t overruns;
+};
+
+}  // namespace capture
@@ -0,0 +1,150 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "config.h"
+#include "crc32.h"
+#include "flashmap.h"
+#include "flashwrite.h"
+#include "logger.h"
+#include <pico/stdlib.h>
+#include <cstddef>
+#include <cstring>
+
+namespace config {
+
+constexpr uint32_t CONFIG_MAGIC = 0x47464341;   // "ACFG"
+constexpr uint16_t CONFIG_VERSION = 1;
+
+// Changes must be stable this long before they are written
+constexpr uint32_t SAVE_DELAY_MS = 3000;
+
+static_assert(sizeof(Settings) <= flashmap::PAGE_SIZE, "Settings must fit in one flash page");
+
+static Settings current;
+static int activeSlot = -1;      // Slot holding the newest valid copy, -1 if none
+static bool dirty = false;
+static uint32_t changedAtMs = 0;
+
+static const Settings* slotAt(uint32_t slot) {
+    return reinterpret_cast<const Settings*>(
+        flashwrite::map(flashmap::CONFIG_OFFSET + slot * flashmap::SECTOR_SIZE));
+}
+
+static uint32_t settingsCrc(const Settings& settings) {
+    return crc::crc32(&settings, offsetof(Settings, crc));
+}
+
+static bool isValid(const Settings* settings) {
+    return settings->magic == CONFIG_MAGIC &&
+           settings->version == CONFIG_VERSION &&
+           settings->size == sizeof(Settings) &&
+           settings->crc == settingsCrc(*settings);
+}
+
+static void setDefaults(Settings& settings) {
+    memset(&settings, 0, sizeof(settings));
+    settings.magic = CONFIG_MAGIC;
+    settings.version = CONFIG_VERSION;
+    settings.size = sizeof(Settings);
+    settings.seaLevelInHgX100 = DEFAULT_PRESSURE_INHG_X100;
+    settings.sensorProfile = 0;
+    settings.displayPeriodMs = DEFAULT_DISPLAY_PERIOD_MS;
+}
+
+const Settings& initConfig() {
+    activeSlot = -1;
+    for (uint32_t slot = 0; slot < flashmap::CONFIG_SLOTS; ++slot) {
+        const Settings* candidate = slotAt(slot);
+        if (!isValid(candidate)) {
+            continue;
+        }
+        if (activeSlot < 0 ||
+            static_cast<int32_t>(candidate->sequence - slotAt(activeSlot)->sequence) > 0) {
+            activeSlot = static_cast<int>(slot);
+        }
+    }
+
+    if (activeSlot >= 0) {
+        // The stored layout is the in-memory layout, so this is the whole load
+        memcpy(&current, slotAt(activeSlot), sizeof(current));
+        logger::log(logger::Msg::ConfigLoaded, activeSlot, current.sequence);
+    } else {
+        setDefaults(current);
+        logger::log(logger::Msg::ConfigDefaults);
+    }
+    dirty = false;
+    return current;
+}
+
+const Settings& get() {
+    return current;
+}
+
+static void markChanged() {
+    dirty = true;
+    changedAtMs = to_ms_since_boot(get_absolute_time());
+}
+
+void setSeaLevel(int32_t inHgX100) {
+    if (current.seaLevelInHgX100 != inHgX100) {
+        current.seaLevelInHgX100 = inHgX100;
+        markChanged();
+    }
+}
+
+void setSensorProfile(uint8_t profile) {
+    if (current.sensorProfile != profile) {
+        current.sensorProfile = profile;
+        markChanged();
+    }
+}
+
+void setDisplayPeriod(uint16_t periodMs) {
+    if (current.displayPeriodMs != periodMs) {
+        current.displayPeriodMs = periodMs;
+        markChanged();
+    }
+}
+
+void service() {
+    if (!dirty) {
+        return;
+    }
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if (now - changedAtMs < SAVE_DELAY_MS) {
+        return;
+    }
+    dirty = false;
+
+    // Changed and changed back: nothing to write
+    if (activeSlot >= 0) {
+        const Settings* stored = slotAt(activeSlot);
+        if (memcmp(&stored->seaLevelInHgX100, &current.seaLevelInHgX100,
+                   offsetof(Settings, crc) - offsetof(Settings, seaLevelInHgX100)) == 0) {
+            return;
+        }
+    }
+
+    // Write the other slot so the current copy survives a power cut mid-save
+    uint32_t slot = activeSlot < 0 ? 0 : (static_cast<uint32_t>(activeSlot) + 1) % flashmap::CONFIG_SLOTS;
+    uint32_t offset = flashmap::CONFIG_OFFSET + slot * flashmap::SECTOR_SIZE;
+
+    Settings next = current;
+    next.sequence = current.sequence + 1;
+    next.crc = settingsCrc(next);
+
+    alignas(4) uint8_t page[flashmap::PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, &next, sizeof(next));
+
+    if (!flashwrite::eraseSector(offset) || !flashwrite::programPage(offset, page) ||
+        !isValid(slotAt(slot))) {
+        logger::log(logger::Msg::ConfigSaveFailed, slot);
+        return;
+    }
+
+    current = next;
+    activeSlot = static_cast<int>(slot);
+    logger::log(logger::Msg::ConfigSaved, slot, current.sequence);
+}
+
+}  // namespace config
@@ -0,0 +1,47 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+// Persistent device configuration. Two flash sectors hold alternate copies,
+// each CRC-checked; the valid copy with the highest sequence wins. Loading is
+// a CRC check of the memory-mapped copy, saving is deferred and coalesced.
+namespace config {
+
+// Default sea level pressure: 29.92 inHg = 2992 in encoder units
+constexpr int32_t DEFAULT_PRESSURE_INHG_X100 = 2992;
+
+// Default display refresh (250ms = 4 updates per second)
+constexpr uint16_t DEFAULT_DISPLAY_PERIOD_MS = 250;
+
+// Stored layout, written as-is to flash
+struct Settings {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;               // sizeof(Settings) when written
+    uint32_t sequence;           // Increases by one per save
+    int32_t seaLevelInHgX100;    // Altimeter setting, inHg * 100
+    uint8_t sensorProfile;       // bmp390::Profile
+    uint8_t reserved;
+    uint16_t displayPeriodMs;
+    uint32_t crc;                // CRC-32 of everything above
+};
+
+// Find the newest valid copy in flash, falling back to defaults
+// Returns the active settings
+const Settings& initConfig();
+
+// Active settings (flash copy or defaults, plus unsaved changes)
+const Settings& get();
+
+// Change settings; the save happens later from service() so a burst of
+// changes costs a single flash write
+void setSeaLevel(int32_t inHgX100);
+void setSensorProfile(uint8_t profile);
+void setDisplayPeriod(uint16_t periodMs);
+
+// Write pending changes once they have been stable for a while
+// Call from the event loop when idle (the display timer keeps it coming)
+void service();
+
+}  // namespace config
@@ -0,0 +1,52 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "crc32.h"
+#include <array>
+#include <cstring>
+
+namespace crc {
+
+// Slicing-by-4: table[k][b] is the CRC of byte b followed by k zero bytes,
+// so four input bytes are folded in with four independent lookups
+using Tables = std::array<std::array<uint32_t, 256>, 4>;
+
+static constexpr Tables makeTables() {
+    Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        }
+        tables[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t k = 1; k < tables.size(); ++k) {
+            tables[k][i] = tables[0][tables[k - 1][i] & 0xFF] ^ (tables[k - 1][i] >> 8);
+        }
+    }
+    return tables;
+}
+
+// Built at compile time so it lives in flash rather than RAM
+static constexpr Tables CRC_TABLES = makeTables();
+
+uint32_t crc32(const void* data, size_t length, uint32_t crc) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    // Both the RP2350 and the host tools are little-endian
+    while (length >= 4) {
+        uint32_t word;
+        memcpy(&word, bytes, sizeof(word));
+        crc ^= word;
+        crc = CRC_TABLES[3][crc & 0xFF] ^ CRC_TABLES[2][(crc >> 8) & 0xFF] ^
+              CRC_TABLES[1][(crc >> 16) & 0xFF] ^ CRC_TABLES[0][crc >> 24];
+        bytes += 4;
+        length -= 4;
+    }
+    while (length--) {
+        crc = CRC_TABLES[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+}  // namespace crc
@@ -0,0 +1,13 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace crc {
+
+// Standard CRC-32 (IEEE 802.3, reflected, as used by zlib)
+// Pass a previous result as crc to continue over several buffers
+uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+
+}  // namespace crc
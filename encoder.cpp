@@ -3,102 +3,169 @@
 #include <pico/stdlib.h>
 #include <pico/critical_section.h>
 #include <hardware/gpio.h>
+#include <hardware/pio.h>
+#include <atomic>
 #include "encoder.h"
 #include "event.h"
 #include "pins.h"
+#include "quadrature.pio.h"
 
 namespace encoder {
 
-// Critical section for thread-safe access to encoder state
+static_assert(PIN_GPIO_ENCODER_DATA == PIN_GPIO_ENCODER_CLOCK + 1,
+              "The quadrature decoder needs the encoder pins to be consecutive");
+
+// Quadrature edges per detent (one full cycle per click)
+constexpr int32_t COUNTS_PER_DETENT = 4;
+
+// How often both pins are sampled. Edges from a fast spin are hundreds of
+// microseconds apart; glitches much shorter than the interval are not seen.
+constexpr float SAMPLE_HZ = 100000.0f;
+
+// How often rotation is checked for events
+constexpr int32_t POLL_INTERVAL_MS = 10;
+
+constexpr uint32_t BUTTON_DEBOUNCE_MS = 50;
+
+static const PIO encoderPio = pio0;
+static uint encoderSm = 0;
+
+// Serializes the writers (the poll timer and setPosition); readers never take it
 static critical_section_t encoderCriticalSection;
 
-// Encoder state (protected by critical section)
-static volatile int32_t encoderPosition = 0;
-static volatile bool buttonPressedFlag = false;
+// Writer state (protected by critical section)
+static int32_t baseCount = 0;        // Decoder count where the position was last set
+static int32_t basePosition = 0;     // Position set at baseCount
+static int32_t reportedPosition = 0; // Position at the last EncoderChange event
+static uint32_t eventThreshold = 1;
+
+// Published state. The position is a single word, so a plain atomic gives
+// readers on either core a consistent value without a seqlock.
+static std::atomic<int32_t> publishedPosition{0};
+static std::atomic<bool> buttonPressedFlag{false};
+static std::atomic<uint32_t> changeTimeUs{0};
+
+static repeating_timer_t pollTimer;
 
-// Debounce timing for button
+// Debounce timing for the button (rotation needs none)
 static volatile uint32_t lastButtonTime = 0;
-constexpr uint32_t BUTTON_DEBOUNCE_MS = 50;
 
-// GPIO interrupt callback
+// Read the decoder count. The state machine pushes it continuously and drops
+// pushes while the FIFO is full, so drain the FIFO and take one fresh value.
+// Call with the critical section held.
+static int32_t readCount() {
+    uint level = pio_sm_get_rx_fifo_level(encoderPio, encoderSm);
+    uint32_t count = 0;
+    for (uint i = 0; i <= level; ++i) {
+        count = pio_sm_get_blocking(encoderPio, encoderSm);
+    }
+    return static_cast<int32_t>(count);
+}
+
+// Position in detents, rounding to the nearest detent. Call with the
+// critical section held.
+static int32_t positionLocked() {
+    int32_t counts = readCount() - baseCount + COUNTS_PER_DETENT / 2;
+    int32_t detents = counts / COUNTS_PER_DETENT;
+    if (counts < 0 && counts % COUNTS_PER_DETENT != 0) {
+        detents--;   // Floor division
+    }
+    return basePosition + detents;
+}
+
+static bool pollCallback(repeating_timer_t* rt) {
+    (void)rt;
+    poll();
+    return true;
+}
+
+// GPIO interrupt callback (button only)
 static void gpio_callback(uint gpio, uint32_t events) {
-    uint32_t currentTime = to_ms_since_boot(get_absolute_time());
-    
-    if (gpio == PIN_GPIO_ENCODER_CLOCK) {
-        // State machine for quadrature decoding
-        // Only trigger on clock falling edge for single-step detection
-        if (events & GPIO_IRQ_EDGE_FALL) {  
-            if ((currentTime - lastButtonTime) > BUTTON_DEBOUNCE_MS) {
-                // Read data pin to determine direction
-                uint8_t data = gpio_get(PIN_GPIO_ENCODER_DATA);
-                
-                int32_t delta;
-                if (data) {
-                    encoderPosition++;  // Clockwise
-                    delta = 1;
-                } else {
-                    encoderPosition--;  // Counter-clockwise
-                    delta = -1;
-                }
-
-                lastButtonTime = currentTime;
-
-                // Queue encoder change event with delta
-                event::queueEventFromISR(event::Event(event::EventType::EncoderChange, delta));
-            }
-            
-            
-        }
+    if (gpio != PIN_GPIO_ENCODER_BUTTON || !(events & GPIO_IRQ_EDGE_FALL)) {
+        return;
     }
-    else if (gpio == PIN_GPIO_ENCODER_BUTTON) {
-        // Button interrupt with debouncing
-        if (events & GPIO_IRQ_EDGE_FALL) {  // Button pressed (active low)
-            if ((currentTime - lastButtonTime) > BUTTON_DEBOUNCE_MS) {
-                buttonPressedFlag = true;
-                lastButtonTime = currentTime;
-                
-                // Queue button press event
-                event::queueEventFromISR(event::Event(event::EventType::ButtonPress));
-            }
-        }
+    // Button pressed (active low), with debouncing
+    uint32_t currentTime = to_ms_since_boot(get_absolute_time());
+    if ((currentTime - lastButtonTime) > BUTTON_DEBOUNCE_MS) {
+        buttonPressedFlag.store(true, std::memory_order_release);
+        lastButtonTime = currentTime;
+
+        // Queue button press event
+        event::queueEventFromISR(event::Event(event::EventType::ButtonPress));
     }
 }
 
 void initEncoder() {
     // Initialize the critical section
     critical_section_init(&encoderCriticalSection);
-    
-    // Set up interrupts for encoder clock pin (falling edge for single-step)
-    gpio_set_irq_enabled_with_callback(PIN_GPIO_ENCODER_CLOCK, 
-                                        GPIO_IRQ_EDGE_FALL, 
-                                        true, 
-                                        &gpio_callback);
-    
+
+    // The decoder uses computed jumps, so it must be loaded at offset 0
+    pio_add_program_at_offset(encoderPio, &quadrature_program, 0);
+    encoderSm = static_cast<uint>(pio_claim_unused_sm(encoderPio, true));
+    quadrature_program_init(encoderPio, encoderSm, PIN_GPIO_ENCODER_CLOCK, SAMPLE_HZ);
+
+    critical_section_enter_blocking(&encoderCriticalSection);
+    baseCount = readCount();
+    basePosition = 0;
+    reportedPosition = 0;
+    publishedPosition.store(0, std::memory_order_release);
+    critical_section_exit(&encoderCriticalSection);
+
+    add_repeating_timer_ms(-POLL_INTERVAL_MS, pollCallback, nullptr, &pollTimer);
+
     // Set up interrupt for button (falling edge = press)
-    gpio_set_irq_enabled(PIN_GPIO_ENCODER_BUTTON, 
-                         GPIO_IRQ_EDGE_FALL, 
-                         true);
+    gpio_set_irq_enabled_with_callback(PIN_GPIO_ENCODER_BUTTON,
+                                       GPIO_IRQ_EDGE_FALL,
+                                       true,
+                                       &gpio_callback);
 }
 
 int32_t getPosition() {
+    return publishedPosition.load(std::memory_order_acquire);
+}
+
+void setPosition(int32_t position) {
     critical_section_enter_blocking(&encoderCriticalSection);
-    int32_t pos = encoderPosition;
+    baseCount = readCount();
+    basePosition = position;
+    reportedPosition = position;
+    publishedPosition.store(position, std::memory_order_release);
     critical_section_exit(&encoderCriticalSection);
-    return pos;
 }
 
-void setPosition(int32_t position) {
+int32_t poll() {
     critical_section_enter_blocking(&encoderCriticalSection);
-    encoderPosition = position;
+    int32_t position = positionLocked();
+    publishedPosition.store(position, std::memory_order_release);
+    int32_t delta = position - reportedPosition;
+    uint32_t distance = delta < 0 ? static_cast<uint32_t>(-delta) : static_cast<uint32_t>(delta);
+    if (delta == 0 || distance < eventThreshold) {
+        delta = 0;
+    } else {
+        reportedPosition = position;
+    }
     critical_section_exit(&encoderCriticalSection);
+
+    if (delta != 0) {
+        changeTimeUs.store(time_us_32(), std::memory_order_release);
+        event::queueEventFromISR(event::Event(event::EventType::EncoderChange, delta));
+    }
+    return delta;
 }
 
-bool wasButtonPressed() {
+uint32_t getChangeTimeUs() {
+    return changeTimeUs.load(std::memory_order_acquire);
+}
+
+void setEventThreshold(uint32_t detents) {
     critical_section_enter_blocking(&encoderCriticalSection);
-    bool pressed = buttonPressedFlag;
-    buttonPressedFlag = false;  // Clear flag after reading
+    eventThreshold = detents ? detents : 1;
     critical_section_exit(&encoderCriticalSection);
-    return pressed;
+}
+
+bool wasButtonPressed() {
+    // Clear flag after reading
+    return buttonPressedFlag.exchange(false, std::memory_order_acq_rel);
 }
 
 bool isButtonPressed() {
@@ -115,4 +182,3 @@ double getPascals() {
 }
 
 }  // namespace encoder
-
@@ -3,28 +3,41 @@
 
 #include <cstdint>
 
+// Rotary encoder decoded by a PIO state machine (quadrature.pio). Rotation
+// costs no CPU interrupts; the position is read on demand and EncoderChange
+// events are posted by a periodic poll once the knob has moved far enough.
 namespace encoder {
 
-// Initialize the encoder interrupt handlers
+// Start the quadrature decoder, the rotation poll and the button interrupt
 // Call this AFTER initializePins() has set up the GPIO
 void initEncoder();
 
-// Get the current encoder position (thread/IRQ safe)
+// Get the encoder position in detents as of the last poll (lock-free, safe
+// from either core and from interrupts)
 int32_t getPosition();
 
 // Convert encoder count (inHg * 100) to Pascals
 double getPascals();
 
-// Set the encoder position (thread/IRQ safe)
+// Set the encoder position (thread safe; takes effect immediately)
 void setPosition(int32_t position);
 
+// Post an EncoderChange event if the position has moved by at least the
+// event threshold since the last one. Returns the change posted (0 if none).
+// Runs periodically on its own; call it to ask for an update immediately.
+int32_t poll();
+
+// When the last EncoderChange event was posted (time_us_32()). The knob
+// moved at most one poll interval (10 ms) before this.
+uint32_t getChangeTimeUs();
+
+// Minimum movement, in detents, that posts an EncoderChange event
+void setEventThreshold(uint32_t detents);
+
 // Check if button was pressed (clears the flag when read)
 bool wasButtonPressed();
 
 // Check current button state (true = pressed, active low)
 bool isButtonPressed();
 
-
-
 }  // namespace encoder
-
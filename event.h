@@ -11,6 +11,10 @@ enum class EventType : uint8_t {
     Timer,              // Periodic timer tick
     EncoderChange,      // Encoder position changed
     ButtonPress,        // Encoder button pressed
+    TaskWake,           // A task's timer expired or its completion was signalled
+    Launch,             // Flight events from the detector; data is the height in feet
+    Apogee,
+    Landing,
 };
 
 // Event structure
@@ -0,0 +1,28 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+// Layout of the on-board QSPI flash (offsets from the start of flash).
+// The program image lives at the bottom; the data stores sit above it.
+namespace flashmap {
+
+constexpr uint32_t FLASH_SIZE = 4 * 1024 * 1024;   // Pico 2
+constexpr uint32_t SECTOR_SIZE = 4096;             // Smallest erasable unit
+constexpr uint32_t PAGE_SIZE = 256;                // Smallest programmable unit
+
+// Space kept free for the program image
+constexpr uint32_t PROGRAM_RESERVED_BYTES = 1024 * 1024;
+
+// Device configuration, two sectors at the top of flash written alternately
+constexpr uint32_t CONFIG_SLOTS = 2;
+constexpr uint32_t CONFIG_OFFSET = FLASH_SIZE - CONFIG_SLOTS * SECTOR_SIZE;
+
+// Flight data log, a circular log of pages between the program and the config
+constexpr uint32_t FLIGHTLOG_OFFSET = PROGRAM_RESERVED_BYTES;
+constexpr uint32_t FLIGHTLOG_SIZE = CONFIG_OFFSET - FLIGHTLOG_OFFSET;
+
+static_assert(FLIGHTLOG_OFFSET % SECTOR_SIZE == 0, "flight log must be sector aligned");
+static_assert(FLIGHTLOG_SIZE % SECTOR_SIZE == 0, "flight log must be whole sectors");
+
+}  // namespace flashmap
@@ -0,0 +1,56 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "flashwrite.h"
+#include "flashmap.h"
+#include "logger.h"
+#include <pico/stdlib.h>
+#include <pico/flash.h>
+#include <hardware/flash.h>
+
+namespace flashwrite {
+
+static_assert(flashmap::FLASH_SIZE == PICO_FLASH_SIZE_BYTES, "flashmap does not match the board");
+static_assert(flashmap::SECTOR_SIZE == FLASH_SECTOR_SIZE, "flashmap does not match the flash");
+static_assert(flashmap::PAGE_SIZE == FLASH_PAGE_SIZE, "flashmap does not match the flash");
+
+// Timeout for getting the other core out of the way of a flash operation
+constexpr uint32_t FLASH_SAFE_TIMEOUT_MS = 100;
+
+// Parameters for the operations run under flash_safe_execute
+struct FlashOp {
+    uint32_t offset;
+    const uint8_t* data;     // nullptr for an erase
+};
+
+static void __not_in_flash_func(runFlashOp)(void* param) {
+    const FlashOp* op = static_cast<const FlashOp*>(param);
+    if (op->data) {
+        flash_range_program(op->offset, op->data, FLASH_PAGE_SIZE);
+    } else {
+        flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+    }
+}
+
+static bool run(uint32_t offset, const uint8_t* data) {
+    FlashOp op = {offset, data};
+    int rc = flash_safe_execute(runFlashOp, &op, FLASH_SAFE_TIMEOUT_MS);
+    if (rc != PICO_OK) {
+        logger::log(logger::Msg::FlashError, offset, rc);
+        return false;
+    }
+    return true;
+}
+
+bool eraseSector(uint32_t offset) {
+    return run(offset, nullptr);
+}
+
+bool programPage(uint32_t offset, const uint8_t* data) {
+    return run(offset, data);
+}
+
+const uint8_t* map(uint32_t offset) {
+    return reinterpret_cast<const uint8_t*>(XIP_BASE + offset);
+}
+
+}  // namespace flashwrite
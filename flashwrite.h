@@ -0,0 +1,20 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+// Erase and program the on-board flash. Both stall execute-in-place for the
+// duration of the operation, so callers schedule them from the event loop.
+// Offsets are from the start of flash (see flashmap.h).
+namespace flashwrite {
+
+// Erase one sector, returns false on failure
+bool eraseSector(uint32_t offset);
+
+// Program one page, returns false on failure
+bool programPage(uint32_t offset, const uint8_t* data);
+
+// Memory-mapped (XIP) view of flash at offset
+const uint8_t* map(uint32_t offset);
+
+}  // namespace flashwrite
@@ -0,0 +1,107 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "flightevents.h"
+#include <cmath>
+
+namespace flightevents {
+
+Detector::Detector() : estimator(verticalspeed::ALTITUDE_NOISE_FEET, ACCELERATION_FEET_PER_S2) {
+    reset();
+}
+
+void Detector::reset() {
+    estimator.reset();
+    phase = Phase::Ground;
+    lastUs = 0;
+    groundFeet = 0.0;
+    haveGround = false;
+    confirm = 0;
+    boostConfirm = 0;
+    stillUs = 0;
+    peakFeet = 0.0;
+    peakUs = 0;
+    stillFeet = 0.0;
+    stillSinceUs = 0;
+    detectedUs = 0;
+    last = Detection{Event::None, 0, 0, 0.0};
+}
+
+Event Detector::detect(Event event, uint64_t eventUs, double altitudeFeet) {
+    last = Detection{event, detectedUs, eventUs, altitudeFeet - groundFeet};
+    confirm = 0;
+    return event;
+}
+
+Event Detector::update(uint64_t timeUs, double altitudeFeet) {
+    // Time going backwards is a new recording
+    if (estimator.getCount() > 0 && timeUs <= lastUs) {
+        reset();
+    }
+    estimator.update(timeUs, altitudeFeet, phase == Phase::Ascent ? -GRAVITY_FEET_PER_S2 : 0.0);
+    double altitude = estimator.getAltitudeFeet();
+    double rate = estimator.getFeetPerMinute() / 60.0;
+    uint64_t intervalUs = timeUs > lastUs ? timeUs - lastUs : 0;
+    lastUs = timeUs;
+    detectedUs = timeUs;
+
+    switch (phase) {
+        case Phase::Ground: {
+            // Follow slow drift (weather, temperature) so it is not a launch
+            if (!haveGround) {
+                groundFeet = altitude;
+                haveGround = true;
+            } else {
+                double seconds = intervalUs * 1e-6;
+                groundFeet += (altitude - groundFeet) * seconds / (GROUND_TIME_CONSTANT_S + seconds);
+            }
+            double height = altitude - groundFeet;
+            bool climbing = height > LAUNCH_HEIGHT_FEET && rate > LAUNCH_FEET_PER_SECOND;
+            confirm = climbing ? confirm + 1 : 0;
+
+            if (rate < STILL_FEET_PER_SECOND) {
+                stillUs = timeUs;
+            }
+            bool boosting = height > BOOST_HEIGHT_FEET && rate > BOOST_FEET_PER_SECOND &&
+                            timeUs - stillUs <= BOOST_WINDOW_US;
+            boostConfirm = boosting ? boostConfirm + 1 : 0;
+            if (confirm >= LAUNCH_CONFIRM || boostConfirm >= BOOST_CONFIRM) {
+                boostConfirm = 0;
+                phase = Phase::Ascent;
+                peakFeet = altitude;
+                peakUs = timeUs;
+                return detect(Event::Launch, timeUs, altitude);
+            }
+            break;
+        }
+
+        case Phase::Ascent:
+            if (altitude > peakFeet) {
+                peakFeet = altitude;
+                peakUs = timeUs;
+            }
+            confirm = rate < 0 ? confirm + 1 : 0;
+            if (confirm >= APOGEE_CONFIRM) {
+                phase = Phase::Descent;
+                stillFeet = altitude;
+                stillSinceUs = timeUs;
+                return detect(Event::Apogee, peakUs, peakFeet);
+            }
+            break;
+
+        case Phase::Descent:
+            if (fabs(altitude - stillFeet) > LANDED_BAND_FEET) {
+                stillFeet = altitude;
+                stillSinceUs = timeUs;
+            } else if (timeUs - stillSinceUs >= LANDED_HOLD_US) {
+                // Ready for the next flight from where it came down
+                Event event = detect(Event::Landing, stillSinceUs, altitude);
+                phase = Phase::Ground;
+                groundFeet = altitude;
+                return event;
+            }
+            break;
+    }
+    return Event::None;
+}
+
+}  // namespace flightevents
@@ -0,0 +1,123 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+#include "verticalspeed.h"
+
+// Launch, apogee and landing detection for rockets, fed every sample the
+// sensor produces. The detector keeps its own altitude and vertical speed
+// estimate, tuned to follow boost and coast rather than to be steady on a
+// display, with gravity as a known acceleration once launched. Detection is
+// bounded: a launch is seen BOOST_CONFIRM samples after the filtered climb
+// passes the boost test (or LAUNCH_CONFIRM after the slower one), apogee
+// APOGEE_CONFIRM samples after the filtered rate goes negative, and landing
+// LANDED_HOLD_US after the descent stops.
+//
+// Launch is not seen within tens of milliseconds of ignition. Barometric
+// height needs a few tenths of a second of boost to stand clear of noise
+// and of an aircraft's climb: on the simulator at 50 Hz a 6 g boost is
+// detected 240-280 ms after ignition. Anything faster needs an
+// accelerometer.
+// No SDK dependencies.
+namespace flightevents {
+
+enum class Event : uint8_t {
+    None,
+    Launch,
+    Apogee,
+    Landing
+};
+
+enum class Phase : uint8_t {
+    Ground,     // Waiting for a launch, tracking the ground level
+    Ascent,     // Launched, waiting for apogee
+    Descent     // Past apogee, waiting for landing
+};
+
+// Launch: height above the ground level and climb rate, both exceeded for
+// LAUNCH_CONFIRM samples in a row. Aircraft and lifts climb at a few tens of
+// feet per second at most. This catches a slow motor the boost test misses.
+constexpr double LAUNCH_HEIGHT_FEET = 5.0;
+constexpr double LAUNCH_FEET_PER_SECOND = 50.0;
+constexpr uint32_t LAUNCH_CONFIRM = 2;
+
+// Boost: a faster launch test on acceleration. The climb rate passes
+// BOOST_FEET_PER_SECOND within BOOST_WINDOW_US of having been below
+// STILL_FEET_PER_SECOND, BOOST_HEIGHT_FEET up, for BOOST_CONFIRM samples in
+// a row. Nothing but a motor gains that speed that quickly; an aircraft or a
+// lift climbing steadily never does.
+constexpr double STILL_FEET_PER_SECOND = 5.0;
+constexpr double BOOST_HEIGHT_FEET = 2.0;
+constexpr double BOOST_FEET_PER_SECOND = 25.0;
+constexpr uint64_t BOOST_WINDOW_US = 250000;
+constexpr uint32_t BOOST_CONFIRM = 2;
+
+// Apogee: the rate below zero for APOGEE_CONFIRM samples in a row
+constexpr uint32_t APOGEE_CONFIRM = 3;
+
+// Landing: the altitude within LANDED_BAND_FEET of where it stopped for
+// LANDED_HOLD_US. Under a parachute the band is crossed in a fraction of a
+// second.
+constexpr double LANDED_BAND_FEET = 3.0;
+constexpr uint64_t LANDED_HOLD_US = 2000000;
+
+// Ground level follows the altitude with this time constant while waiting
+constexpr double GROUND_TIME_CONSTANT_S = 10.0;
+
+// The detector's estimate follows accelerations of this size (1 sigma)
+// beyond the known one
+constexpr double ACCELERATION_FEET_PER_S2 = 100.0;
+constexpr double GRAVITY_FEET_PER_S2 = 32.174;
+
+// What happened, when it was detected and the best estimate of when it
+// actually happened (the peak for apogee, the start of the stillness for
+// landing; launch is dated when detected)
+struct Detection {
+    Event event;
+    uint64_t detectedUs;
+    uint64_t eventUs;
+    double altitudeFeet;        // Above the ground level at launch
+};
+
+class Detector {
+public:
+    Detector();
+
+    // Start over on the ground
+    void reset();
+
+    // Add the altitude (feet, any fixed reference) measured at timeUs.
+    // Returns the event detected at this sample, if any.
+    Event update(uint64_t timeUs, double altitudeFeet);
+
+    Phase getPhase() const { return phase; }
+
+    // Last event detected (event is None before the first)
+    const Detection& getLastDetection() const { return last; }
+
+    // The detector's vertical speed estimate, feet per minute
+    double getFeetPerMinute() const { return estimator.getFeetPerMinute(); }
+
+private:
+    Event detect(Event event, uint64_t eventUs, double altitudeFeet);
+
+    verticalspeed::Estimator estimator;
+    Phase phase;
+    uint64_t lastUs;
+
+    double groundFeet;
+    bool haveGround;
+
+    uint32_t confirm;           // Samples in a row meeting the current test
+    uint32_t boostConfirm;      // Samples in a row meeting the boost test
+    uint64_t stillUs;            // Last time the climb rate was below STILL_FEET_PER_SECOND
+    double peakFeet;
+    uint64_t peakUs;
+    double stillFeet;           // Where the altitude stopped
+    uint64_t stillSinceUs;
+
+    uint64_t detectedUs;        // Time of the sample being processed
+    Detection last;
+};
+
+}  // namespace flightevents
@@ -0,0 +1,233 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "flightlog.h"
+#include "flashmap.h"
+#include "flashwrite.h"
+#include "logger.h"
+#include "samplecodec.h"
+#include <pico/stdlib.h>
+#include <cmath>
+#include <cstring>
+
+// End of the program image, provided by the linker script
+extern char __flash_binary_end;
+
+namespace flightlog {
+
+using logformat::PageHeader;
+using logformat::PAGE_SIZE;
+
+constexpr uint32_t LOG_SIZE = flashmap::FLIGHTLOG_SIZE;
+constexpr uint32_t SECTOR_SIZE = flashmap::SECTOR_SIZE;
+
+// One page being filled plus this many waiting for flash. While one waits
+// the page being filled stays empty (see append()).
+constexpr uint32_t QUEUE_DEPTH = 1;
+constexpr uint32_t PAGE_BUFFERS = QUEUE_DEPTH + 1;
+
+static bool enabled = false;
+
+// Page buffers: queue of full pages, then the page being filled
+alignas(4) static uint8_t pages[PAGE_BUFFERS][PAGE_SIZE];
+static uint32_t queueHead = 0;     // Oldest full page
+static uint32_t queueCount = 0;    // Full pages waiting for flash
+static uint32_t fillIndex = 0;     // Page being filled
+static uint32_t fillCount = 0;     // Records in the page being filled
+static size_t fillLength = 0;      // Payload bytes used in the page being filled
+static codec::Encoder encoder;
+
+static uint32_t headOffset = 0;    // Log offset of the next page to program
+static uint32_t erasedAhead = 0;   // Bytes known erased starting at headOffset
+static uint32_t nextSequence = 0;
+static uint16_t session = 0;
+static uint32_t seaLevelCentiPa = 0;
+static uint32_t droppedCount = 0;
+
+static const uint8_t* pageAt(uint32_t logOffset) {
+    return flashwrite::map(flashmap::FLIGHTLOG_OFFSET + logOffset);
+}
+
+static void startPage() {
+    uint8_t* page = pages[fillIndex];
+    memset(page, 0xFF, PAGE_SIZE);
+    fillCount = 0;
+    fillLength = 0;
+
+    // Every page starts with a keyframe so it decodes on its own
+    encoder.reset();
+}
+
+// Move the page being filled onto the flash queue
+static void closePage() {
+    if (fillCount == 0) {
+        return;
+    }
+
+    uint8_t* page = pages[fillIndex];
+    PageHeader header = {};
+    header.magic = logformat::PAGE_MAGIC;
+    header.sequence = nextSequence++;
+    header.session = session;
+    header.format = logformat::PAGE_FORMAT_DELTA;
+    header.count = static_cast<uint8_t>(fillCount);
+    header.payloadLength = static_cast<uint16_t>(fillLength);
+    header.seaLevelCentiPa = seaLevelCentiPa;
+    memcpy(page, &header, sizeof(header));
+    logformat::sealPage(page);
+
+    queueCount++;
+    fillIndex = (fillIndex + 1) % PAGE_BUFFERS;
+    startPage();
+}
+
+bool initFlightLog() {
+    uintptr_t imageEnd = reinterpret_cast<uintptr_t>(&__flash_binary_end) -
+                         reinterpret_cast<uintptr_t>(flashwrite::map(0));
+    if (imageEnd > flashmap::FLIGHTLOG_OFFSET) {
+        logger::log(logger::Msg::FlightLogImageOverlap, static_cast<uint32_t>(imageEnd));
+        return false;
+    }
+
+    // The first page of a sector is always written first, so the newest
+    // sector is the one whose first page has the highest sequence number
+    bool found = false;
+    uint32_t newestSector = 0;
+    uint32_t newestSequence = 0;
+    for (uint32_t sector = 0; sector < LOG_SIZE; sector += SECTOR_SIZE) {
+        const uint8_t* page = pageAt(sector);
+        if (!logformat::isValidPage(page)) {
+            continue;
+        }
+        uint32_t sequence = logformat::getHeader(page)->sequence;
+        if (!found || static_cast<int32_t>(sequence - newestSequence) > 0) {
+            found = true;
+            newestSector = sector;
+            newestSequence = sequence;
+        }
+    }
+
+    if (!found) {
+        // Empty or foreign log, start over at the bottom
+        headOffset = 0;
+        erasedAhead = 0;
+        nextSequence = 0;
+        session = 0;
+    } else {
+        // Walk the newest sector to the last good page
+        uint32_t offset = newestSector;
+        const PageHeader* last = logformat::getHeader(pageAt(offset));
+        for (offset += PAGE_SIZE; offset < newestSector + SECTOR_SIZE; offset += PAGE_SIZE) {
+            const uint8_t* page = pageAt(offset);
+            if (!logformat::isValidPage(page) ||
+                logformat::getHeader(page)->sequence != last->sequence + 1) {
+                break;
+            }
+            last = logformat::getHeader(page);
+        }
+        nextSequence = last->sequence + 1;
+        session = static_cast<uint16_t>(last->session + 1);
+
+        // Reuse the rest of the sector only if it is still clean; a page torn
+        // by a power cut means skipping to the next sector
+        headOffset = offset;
+        erasedAhead = 0;
+        for (uint32_t check = offset; check < newestSector + SECTOR_SIZE; check += PAGE_SIZE) {
+            if (!logformat::isErasedPage(pageAt(check))) {
+                headOffset = (newestSector + SECTOR_SIZE) % LOG_SIZE;
+                erasedAhead = 0;
+                break;
+            }
+            erasedAhead += PAGE_SIZE;
+        }
+        if (headOffset == newestSector + SECTOR_SIZE) {
+            headOffset %= LOG_SIZE;
+        }
+    }
+
+    queueHead = 0;
+    queueCount = 0;
+    fillIndex = 0;
+    startPage();
+    enabled = true;
+
+    logger::log(logger::Msg::FlightLogResumed, session, headOffset, nextSequence);
+    return true;
+}
+
+void setSeaLevelPressure(double pascals) {
+    uint32_t centiPa = static_cast<uint32_t>(lround(pascals * 100.0));
+    if (centiPa != seaLevelCentiPa) {
+        // Each page carries a single altimeter setting
+        closePage();
+        seaLevelCentiPa = centiPa;
+    }
+}
+
+bool append(const logformat::Record& record) {
+    if (!enabled) {
+        return false;
+    }
+
+    // Nothing goes into the next page until the full one is in flash, so
+    // at most a page of samples is ever only in RAM
+    if (queueCount > 0) {
+        droppedCount++;
+        return false;
+    }
+
+    uint8_t* payload = pages[fillIndex] + sizeof(PageHeader);
+    size_t used = encoder.encode(record, payload + fillLength, logformat::PAGE_PAYLOAD_SIZE - fillLength);
+    if (used == 0) {
+        droppedCount++;
+        return false;
+    }
+    fillLength += used;
+    fillCount++;
+
+    // Hand the page to the flash queue once the largest sample might not
+    // fit, so it is programmed before the next sample rather than with it
+    if (logformat::PAGE_PAYLOAD_SIZE - fillLength < codec::MAX_SAMPLE_BYTES) {
+        closePage();
+    }
+    return true;
+}
+
+bool service() {
+    if (!enabled) {
+        return false;
+    }
+
+    if (queueCount > 0 && erasedAhead >= PAGE_SIZE) {
+        if (flashwrite::programPage(flashmap::FLIGHTLOG_OFFSET + headOffset, pages[queueHead])) {
+            headOffset = (headOffset + PAGE_SIZE) % LOG_SIZE;
+            erasedAhead -= PAGE_SIZE;
+        }
+        // A failed program drops the page rather than retrying forever
+        queueHead = (queueHead + 1) % PAGE_BUFFERS;
+        queueCount--;
+    } else if (erasedAhead <= SECTOR_SIZE) {
+        // Keep a whole sector erased beyond the head; on wraparound this
+        // reclaims the oldest sector, spreading wear evenly over the log
+        uint32_t sector = (headOffset + erasedAhead) % LOG_SIZE;
+        if (flashwrite::eraseSector(flashmap::FLIGHTLOG_OFFSET + sector)) {
+            erasedAhead += SECTOR_SIZE;
+        }
+        return true;
+    }
+
+    return queueCount > 0 || erasedAhead <= SECTOR_SIZE;
+}
+
+uint16_t getSession() {
+    return session;
+}
+
+uint32_t getDroppedCount() {
+    return droppedCount;
+}
+
+uint32_t getPendingPages() {
+    return queueCount;
+}
+
+}  // namespace flightlog
@@ -0,0 +1,44 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+#include "logformat.h"
+
+// Flight data logger. Samples are compressed into page-sized RAM buffers; full
+// pages are programmed into a circular log in on-board flash by service(),
+// which erases sectors ahead of the write head. A page is closed as soon as
+// it might not take another sample, and nothing goes into the next page
+// until it is in flash, so RAM never holds more than one page of samples and
+// that is all a power cut can lose.
+namespace flightlog {
+
+// Find the write head by scanning the log and start a new session
+// Returns false if the log cannot be used (the logger then stays disabled)
+bool initFlightLog();
+
+// Record the altimeter setting stored with subsequent pages
+void setSeaLevelPressure(double pascals);
+
+// Add a sample (RAM only, never touches flash)
+// Returns false if a full page is still waiting for flash and the sample was
+// dropped (service() programs it in the idle time after the sample that
+// filled it, so this only happens if the loop never went idle)
+bool append(const logformat::Record& record);
+
+// Perform at most one pending flash operation (sector erase or page program)
+// Flash is unreadable while it runs, so call this from the event loop just
+// after a sample has been taken, when the longest quiet time lies ahead
+// Returns true if more flash work is pending
+bool service();
+
+// Current session (boot) number
+uint16_t getSession();
+
+// Number of samples dropped because a full page was waiting for flash
+uint32_t getDroppedCount();
+
+// Full pages waiting for flash. Background writers (event capture) hold off
+// while this is non-zero so regular samples always find room.
+uint32_t getPendingPages();
+
+}  // namespace flightlog
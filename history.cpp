@@ -0,0 +1,167 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "history.h"
+#include <cmath>
+
+namespace history {
+
+static_assert(LEVEL_COUNT > 0, "History needs at least one level");
+
+constexpr bool levelsNested() {
+    for (size_t i = 1; i < LEVEL_COUNT; ++i) {
+        if (LEVELS[i].periodMs % LEVELS[i - 1].periodMs != 0 || LEVELS[i].periodMs <= LEVELS[i - 1].periodMs) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(levelsNested(), "Each level's period must be a whole multiple of the one before");
+
+static uint16_t quantize(double pressurePa) {
+    long value = lround(pressurePa) - BASE_PA;
+    return static_cast<uint16_t>(value < 0 ? 0 : value > UINT16_MAX ? UINT16_MAX : value);
+}
+
+History::History() {
+    Entry* next = storage;
+    for (size_t i = 0; i < LEVEL_COUNT; ++i) {
+        levels[i].ring = next;
+        levels[i].size = LEVELS[i].entries;
+        next += LEVELS[i].entries;
+    }
+    reset();
+}
+
+void History::reset() {
+    for (Level& level : levels) {
+        level.head = 0;
+        level.count = 0;
+        level.sum = 0;
+        level.inputs = 0;
+        level.ringSum = 0;
+        level.ringWeighted = 0;
+    }
+    started = false;
+    bucketStartMs = 0;
+    last = Entry{0, 0, 0};
+}
+
+void History::accumulate(size_t index, uint16_t mean, uint16_t min, uint16_t max) {
+    Level& level = levels[index];
+    if (level.inputs == 0) {
+        level.min = min;
+        level.max = max;
+    } else {
+        level.min = min < level.min ? min : level.min;
+        level.max = max > level.max ? max : level.max;
+    }
+    level.sum += mean;
+    level.inputs++;
+}
+
+// Store the entry being built at a level and pass it up. Returns the number
+// of levels that completed an entry.
+size_t History::close(size_t index) {
+    Level& level = levels[index];
+    Entry entry = {static_cast<uint16_t>((level.sum + level.inputs / 2) / level.inputs), level.min, level.max};
+    level.sum = 0;
+    level.inputs = 0;
+
+    // Keep the running sums: when the oldest entry goes, every other one
+    // moves down a position
+    if (level.count == level.size) {
+        level.ringSum -= level.ring[level.head].mean;
+        level.ringWeighted -= level.ringSum;
+        level.ringWeighted += static_cast<int64_t>(level.size - 1) * entry.mean;
+    } else {
+        level.ringWeighted += static_cast<int64_t>(level.count) * entry.mean;
+        level.count++;
+    }
+    level.ringSum += entry.mean;
+    level.ring[level.head] = entry;
+    level.head = (level.head + 1) % level.size;
+    if (index == 0) {
+        last = entry;
+    }
+
+    size_t completed = index + 1;
+    if (index + 1 < LEVEL_COUNT) {
+        accumulate(index + 1, entry.mean, entry.min, entry.max);
+        if (levels[index + 1].inputs == LEVELS[index + 1].periodMs / LEVELS[index].periodMs) {
+            completed = close(index + 1);
+        }
+    }
+    return completed;
+}
+
+size_t History::add(uint32_t timeMs, double pressurePa) {
+    // Time going backwards is a new recording; a long gap would leave the
+    // rings unevenly spaced
+    if (started && (static_cast<int32_t>(timeMs - bucketStartMs) < 0 || timeMs - bucketStartMs > MAX_GAP_MS)) {
+        reset();
+    }
+    if (!started) {
+        started = true;
+        bucketStartMs = timeMs;
+    }
+
+    size_t completed = 0;
+    uint32_t periodMs = LEVELS[0].periodMs;
+    while (timeMs - bucketStartMs >= periodMs) {
+        if (levels[0].inputs == 0) {
+            accumulate(0, last.mean, last.min, last.max);
+        }
+        size_t closed = close(0);
+        completed = closed > completed ? closed : completed;
+        bucketStartMs += periodMs;
+    }
+
+    uint16_t value = quantize(pressurePa);
+    accumulate(0, value, value, value);
+    return completed;
+}
+
+const History::Entry& History::at(size_t index, size_t age) const {
+    const Level& level = levels[index];
+    return level.ring[(level.head + level.size - 1 - age) % level.size];
+}
+
+Stats History::get(size_t level, size_t age) const {
+    const Entry& entry = at(level, age);
+    return Stats{static_cast<double>(BASE_PA + entry.mean), static_cast<double>(BASE_PA + entry.min),
+                 static_cast<double>(BASE_PA + entry.max)};
+}
+
+double History::getMeanPa(size_t index) const {
+    const Level& level = levels[index];
+    if (level.count == 0) {
+        return NAN;
+    }
+    return BASE_PA + static_cast<double>(level.ringSum) / level.count;
+}
+
+double History::getTrendPaPerHour(size_t index) const {
+    const Level& level = levels[index];
+    if (level.count < 2) {
+        return NAN;
+    }
+    // Positions 0..n-1: sum x = n(n-1)/2, sum x^2 = (n-1)n(2n-1)/6
+    double n = level.count;
+    double sumX = n * (n - 1.0) / 2.0;
+    double sumXX = (n - 1.0) * n * (2.0 * n - 1.0) / 6.0;
+    double slope = (n * level.ringWeighted - sumX * level.ringSum) / (n * sumXX - sumX * sumX);
+    return slope * 3600000.0 / LEVELS[index].periodMs;
+}
+
+double History::getTendencyPa(uint32_t spanMs) const {
+    for (size_t i = 0; i < LEVEL_COUNT; ++i) {
+        uint32_t periodMs = LEVELS[i].periodMs;
+        size_t age = (spanMs + periodMs / 2) / periodMs;
+        if (age > 0 && age < levels[i].count) {
+            return static_cast<double>(at(i, 0).mean) - at(i, age).mean;
+        }
+    }
+    return NAN;
+}
+
+}  // namespace history
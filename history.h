@@ -0,0 +1,117 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Long-term pressure history for weather trends. Cascaded rings hold the
+// pressure at falling resolution: each level averages its entries from the
+// level below (or from samples, at the finest level), keeping the mean,
+// minimum and maximum. Every level also keeps running sums over its ring so
+// its mean and least squares trend are O(1) to query. Pressures are stored as
+// whole pascals, a week fits in about 16 KB. No SDK dependencies.
+namespace history {
+
+struct LevelSpec {
+    uint32_t periodMs;          // Time each entry covers
+    uint16_t entries;           // Ring size
+};
+
+// 1 s for 10 minutes, 1 min for 24 hours, 15 min for a week. Each period is a
+// whole number of the one before.
+constexpr LevelSpec LEVELS[] = {
+    {1000, 600},
+    {60000, 1440},
+    {900000, 672},
+};
+constexpr size_t LEVEL_COUNT = sizeof(LEVELS) / sizeof(LEVELS[0]);
+
+constexpr size_t totalEntries() {
+    size_t total = 0;
+    for (const LevelSpec& spec : LEVELS) {
+        total += spec.entries;
+    }
+    return total;
+}
+constexpr size_t TOTAL_ENTRIES = totalEntries();
+
+// A gap in the samples longer than this starts the history again (short
+// ones, a sensor recovering, repeat the last entry to keep the spacing)
+constexpr uint32_t MAX_GAP_MS = 60000;
+
+// Stored pressures are whole pascals above this, 400 to 1055 hPa
+constexpr int32_t BASE_PA = 40000;
+
+// One entry, in pascals
+struct Stats {
+    double meanPa;
+    double minPa;
+    double maxPa;
+};
+
+class History {
+public:
+    History();
+
+    // Forget everything
+    void reset();
+
+    // Add a pressure sample taken at timeMs. Returns the number of levels
+    // that completed an entry with it, finest first (0 if none).
+    size_t add(uint32_t timeMs, double pressurePa);
+
+    // Entries held at a level
+    size_t getCount(size_t level) const { return levels[level].count; }
+
+    // Entry age periods before the newest (0) at a level; age < getCount()
+    Stats get(size_t level, size_t age) const;
+
+    // Mean of the entries held at a level (NAN if none)
+    double getMeanPa(size_t level) const;
+
+    // Least squares slope through the entries held at a level, pascals per
+    // hour (NAN with fewer than two)
+    double getTrendPaPerHour(size_t level) const;
+
+    // Change of the mean pressure over spanMs, from the finest level that
+    // holds that far back (NAN if none does). Three hours gives the
+    // barometric tendency.
+    double getTendencyPa(uint32_t spanMs) const;
+
+private:
+    struct Entry {
+        uint16_t mean;
+        uint16_t min;
+        uint16_t max;
+    };
+
+    struct Level {
+        Entry* ring;
+        uint16_t size;
+        uint16_t head;          // Next slot to write
+        uint16_t count;
+
+        // Entry being built: sum and number of inputs, extremes
+        uint32_t sum;
+        uint32_t inputs;
+        uint16_t min;
+        uint16_t max;
+
+        // Over the ring: sum of means, and sum of means weighted by their
+        // position (0 the oldest) for the trend
+        int64_t ringSum;
+        int64_t ringWeighted;
+    };
+
+    void accumulate(size_t level, uint16_t mean, uint16_t min, uint16_t max);
+    size_t close(size_t level);
+    const Entry& at(size_t level, size_t age) const;
+
+    Entry storage[TOTAL_ENTRIES];
+    Level levels[LEVEL_COUNT];
+    bool started;
+    uint32_t bucketStartMs;     // Start of the finest level's entry being built
+    Entry last;                 // Newest finest level entry, repeated over gaps
+};
+
+}  // namespace history
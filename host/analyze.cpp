@@ -0,0 +1,292 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+//
+// Flight log analysis. Decodes flash dumps or telemetry captures and prints
+// a summary per flight (one flight per boot session).
+//
+// Usage: pico-altimeter-analyze [options] file...
+//   --stream        inputs are raw codec streams rather than flash dumps
+//   --qnh PA        sea level pressure for streams (default 101325)
+//   --csv FILE      write every sample as CSV
+//   --columns DIR   write every sample as one little-endian binary file per column
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include "logformat.h"
+#include "logreader.h"
+
+constexpr double FEET_PER_METER = 3.28084;
+
+// Climb rates are measured over this window to keep sensor noise out
+constexpr uint32_t RATE_WINDOW_MS = 2000;
+
+// A sample is a gap if it arrives this many typical periods late
+constexpr double GAP_FACTOR = 2.5;
+
+// Barometric formula h = K * (1 - (p / p0)^A), expanded to second order
+// around the first sample of each page. Pressure moves by at most a few
+// hundred Pa within a page, where the truncation error is well under a
+// millimetre, and it saves a pow() per sample.
+class AltitudeModel {
+public:
+    void prepare(double seaLevelPa, int32_t referenceCentiPa) {
+        reference = referenceCentiPa / 100.0;
+        if (reference <= 0 || seaLevelPa <= 0) {
+            base = slope = curvature = 0.0;
+            return;
+        }
+        double ratio = pow(reference / seaLevelPa, A);
+        base = K * (1.0 - ratio);
+        slope = -K * A * ratio / reference;
+        curvature = -K * A * (A - 1.0) * ratio / (reference * reference) / 2.0;
+    }
+
+    double feet(int32_t pressureCentiPa) const {
+        double dp = pressureCentiPa / 100.0 - reference;
+        return base + dp * (slope + dp * curvature);
+    }
+
+private:
+    static constexpr double K = 44330.0 * FEET_PER_METER;
+    static constexpr double A = 0.1903;
+    double reference = 0.0;
+    double base = 0.0;
+    double slope = 0.0;
+    double curvature = 0.0;
+};
+
+// Statistics for one flight, accumulated sample by sample in time order
+struct FlightSummary {
+    std::string source;
+    uint16_t session = 0;
+    size_t samples = 0;
+    size_t errors = 0;
+    size_t gaps = 0;
+    size_t captured = 0;         // Event capture samples, kept out of the statistics
+    uint32_t firstMs = 0;
+    uint32_t lastMs = 0;
+    uint32_t maxGapMs = 0;
+    double periodMs = 0.0;       // Running estimate of the sample period
+    double groundFeet = 0.0;
+    double maxFeet = -1e9;
+    double maxClimbFpm = 0.0;
+    double maxSinkFpm = 0.0;
+    std::deque<std::pair<uint32_t, double>> window;
+
+    void add(const logformat::Record& record, double feet) {
+        // Captures repeat regular samples at full rate, late and out of order
+        if (record.flags & logformat::RECORD_CAPTURE) {
+            captured++;
+            return;
+        }
+        if (record.flags & logformat::RECORD_SENSOR_ERROR) {
+            errors++;
+        }
+        if (samples == 0) {
+            firstMs = record.timeMs;
+            groundFeet = feet;
+        } else {
+            uint32_t delta = record.timeMs - lastMs;
+            if (periodMs > 0.0 && delta > GAP_FACTOR * periodMs) {
+                gaps++;
+                if (delta > maxGapMs) {
+                    maxGapMs = delta;
+                }
+                window.clear();
+            } else {
+                periodMs = periodMs == 0.0 ? delta : periodMs + (delta - periodMs) / 16.0;
+            }
+        }
+        lastMs = record.timeMs;
+        samples++;
+
+        if (record.flags & logformat::RECORD_SENSOR_ERROR) {
+            return;
+        }
+        if (feet > maxFeet) {
+            maxFeet = feet;
+        }
+
+        window.emplace_back(record.timeMs, feet);
+        while (window.size() > 1 && record.timeMs - window.front().first > RATE_WINDOW_MS) {
+            window.pop_front();
+        }
+        uint32_t span = record.timeMs - window.front().first;
+        if (span >= RATE_WINDOW_MS / 2) {
+            double fpm = (feet - window.front().second) / (span / 60000.0);
+            if (fpm > maxClimbFpm) {
+                maxClimbFpm = fpm;
+            }
+            if (-fpm > maxSinkFpm) {
+                maxSinkFpm = -fpm;
+            }
+        }
+    }
+
+    void print() const {
+        printf("%s session %u: %zu samples, %.1f s, period %.1f ms\n", source.c_str(), (unsigned)session,
+               samples, (lastMs - firstMs) / 1000.0, periodMs);
+        printf("  max altitude %.0f ft (%.0f ft above start)\n", maxFeet, maxFeet - groundFeet);
+        printf("  max climb %.0f ft/min, max sink %.0f ft/min\n", maxClimbFpm, maxSinkFpm);
+        printf("  gaps %zu (longest %u ms), sensor errors %zu\n", gaps, (unsigned)maxGapMs, errors);
+        if (captured > 0) {
+            printf("  event captures %zu samples\n", captured);
+        }
+    }
+};
+
+// One little-endian binary file per column, plus a schema description
+class ColumnWriter {
+public:
+    bool open(const std::string& dir) {
+        static const char* const NAMES[] = {"session.u16", "time_ms.u32", "pressure_centipa.i32",
+                                            "temperature_centic.i16", "flags.u16", "altitude_ft.f32"};
+        for (size_t i = 0; i < COLUMNS; ++i) {
+            files[i] = fopen((dir + "/" + NAMES[i]).c_str(), "wb");
+            if (!files[i]) {
+                return false;
+            }
+        }
+        FILE* schema = fopen((dir + "/schema.txt").c_str(), "w");
+        if (!schema) {
+            return false;
+        }
+        for (const char* name : NAMES) {
+            fprintf(schema, "%s\n", name);
+        }
+        fclose(schema);
+        return true;
+    }
+
+    void write(uint16_t session, const logformat::Record& record, float feet) {
+        fwrite(&session, sizeof(session), 1, files[0]);
+        fwrite(&record.timeMs, sizeof(record.timeMs), 1, files[1]);
+        fwrite(&record.pressureCentiPa, sizeof(record.pressureCentiPa), 1, files[2]);
+        fwrite(&record.temperatureCentiC, sizeof(record.temperatureCentiC), 1, files[3]);
+        fwrite(&record.flags, sizeof(record.flags), 1, files[4]);
+        fwrite(&feet, sizeof(feet), 1, files[5]);
+    }
+
+    ~ColumnWriter() {
+        for (FILE* file : files) {
+            if (file) {
+                fclose(file);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t COLUMNS = 6;
+    FILE* files[COLUMNS] = {};
+};
+
+static void usage() {
+    fprintf(stderr, "Usage: pico-altimeter-analyze [--stream] [--qnh PA] [--csv FILE] [--columns DIR] file...\n");
+}
+
+int main(int argc, char** argv) {
+    bool stream = false;
+    double defaultSeaLevelPa = 101325.0;
+    const char* csvPath = nullptr;
+    const char* columnsDir = nullptr;
+    std::vector<const char*> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--stream")) {
+            stream = true;
+        } else if (!strcmp(argv[i], "--qnh") && i + 1 < argc) {
+            defaultSeaLevelPa = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--csv") && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (!strcmp(argv[i], "--columns") && i + 1 < argc) {
+            columnsDir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 1;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty()) {
+        usage();
+        return 1;
+    }
+
+    FILE* csv = nullptr;
+    if (csvPath) {
+        csv = fopen(csvPath, "w");
+        if (!csv) {
+            fprintf(stderr, "Cannot write %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csv, "source,session,time_ms,pressure_pa,temperature_c,altitude_ft,flags\n");
+    }
+    ColumnWriter columns;
+    if (columnsDir && !columns.open(columnsDir)) {
+        fprintf(stderr, "Cannot write columns to %s\n", columnsDir);
+        return 1;
+    }
+
+    size_t totalBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const char* input : inputs) {
+        logreader::MappedFile file;
+        if (!file.open(input)) {
+            fprintf(stderr, "Cannot read %s\n", input);
+            return 1;
+        }
+
+        std::map<uint16_t, FlightSummary> flights;
+        auto visit = [&](const logreader::PageInfo& page, const logformat::Record* records, size_t count) {
+            FlightSummary& flight = flights[page.session];
+            if (flight.samples == 0) {
+                flight.source = input;
+                flight.session = page.session;
+            }
+            if (count == 0) {
+                return;
+            }
+            double seaLevelPa = page.seaLevelCentiPa ? page.seaLevelCentiPa / 100.0 : defaultSeaLevelPa;
+            AltitudeModel altitude;
+            altitude.prepare(seaLevelPa, records[0].pressureCentiPa);
+            for (size_t i = 0; i < count; ++i) {
+                double feet = altitude.feet(records[i].pressureCentiPa);
+                flight.add(records[i], feet);
+                if (csv) {
+                    fprintf(csv, "%s,%u,%u,%.2f,%.2f,%.1f,%u\n", input, (unsigned)page.session,
+                            (unsigned)records[i].timeMs, records[i].pressureCentiPa / 100.0,
+                            records[i].temperatureCentiC / 100.0, feet, (unsigned)records[i].flags);
+                }
+                if (columnsDir) {
+                    columns.write(page.session, records[i], static_cast<float>(feet));
+                }
+            }
+        };
+
+        logreader::ReadStats stats = stream ? logreader::readStream(file.data(), file.size(), visit)
+                                            : logreader::readFlashDump(file.data(), file.size(), visit);
+        totalBytes += stats.bytes;
+
+        for (const auto& entry : flights) {
+            entry.second.print();
+        }
+        printf("%s: %zu records, %zu pages, %zu corrupt pages, %zu resync bytes\n", input, stats.records,
+               stats.validPages, stats.corruptPages, stats.resyncs);
+    }
+
+    if (csv) {
+        fclose(csv);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "Processed %.1f MB in %.3f s (%.0f MB/s)\n", totalBytes / 1e6, seconds,
+            seconds > 0 ? totalBytes / seconds / 1e6 : 0.0);
+    return 0;
+}
@@ -0,0 +1,497 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+//
+// Benchmarks for the firmware hot paths, run on the host against simulated
+// hardware (host/sim). Results are written as JSON for tracking across commits.
+//
+// Usage: pico-altimeter-bench [--filter TEXT] [--min-time SECONDS] [--commit ID] [--out FILE]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bmp390.h"
+#include "crc32.h"
+#include "event.h"
+#include "flightevents.h"
+#include "hardware/i2c.h"
+#include "history.h"
+#include "ht16k33.h"
+#include "logformat.h"
+#include "logger.h"
+#include "outlier.h"
+#include "pipeline.h"
+#include "replay.h"
+#include "samplecodec.h"
+#include "sim.h"
+#include "trace.h"
+
+extern "C" {
+#include "bmp3_internal.h"
+}
+
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "unknown"
+#endif
+
+// Repetitions of each benchmark; the median is reported
+constexpr int REPETITIONS = 5;
+
+// Keep a value alive without letting the compiler see it is unused
+template <typename T>
+static inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    const char* kind;        // "micro" or "macro"
+    uint64_t iterations;     // Operations per repetition
+    double nsPerOp;          // Median over repetitions
+    double minNsPerOp;
+};
+
+static std::vector<Result> results;
+static const char* filter = nullptr;
+static double minSeconds = 0.2;
+
+// Time body(iterations) and record ns per operation. body performs
+// iterations operations (opsPerCall scales it for batched operations).
+template <typename Body>
+static void bench(const char* name, const char* kind, Body body, uint64_t opsPerCall = 1) {
+    if (filter && !strstr(name, filter)) {
+        return;
+    }
+    using Clock = std::chrono::steady_clock;
+
+    // Grow the iteration count until one repetition takes minSeconds / REPETITIONS
+    uint64_t iterations = 1;
+    while (true) {
+        auto start = Clock::now();
+        body(iterations);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= minSeconds / REPETITIONS || iterations >= (1ull << 40)) {
+            break;
+        }
+        iterations *= seconds < 1e-4 ? 10 : 2;
+    }
+
+    std::vector<double> samples;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        auto start = Clock::now();
+        body(iterations);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        samples.push_back(seconds * 1e9 / (iterations * opsPerCall));
+    }
+    std::sort(samples.begin(), samples.end());
+    results.push_back({name, kind, iterations * opsPerCall, samples[REPETITIONS / 2], samples[0]});
+    fprintf(stderr, "  %-34s %10.1f ns/op\n", name, samples[REPETITIONS / 2]);
+}
+
+// Raw sensor readings for a synthetic flight, as the sensor would report them
+static std::vector<sim::RawSample> makeRawFlight(const std::vector<logformat::Record>& flight, size_t count) {
+    std::vector<sim::RawSample> raw;
+    size_t step = std::max<size_t>(1, flight.size() / count);
+    for (size_t i = 0; i < flight.size() && raw.size() < count; i += step) {
+        raw.push_back(sim::rawForSample(flight[i].pressureCentiPa / 100.0, flight[i].temperatureCentiC / 100.0));
+    }
+    return raw;
+}
+
+static void sensorRegisters(const sim::RawSample& raw, uint8_t* regs) {
+    regs[0] = raw.pressure & 0xFF;
+    regs[1] = (raw.pressure >> 8) & 0xFF;
+    regs[2] = (raw.pressure >> 16) & 0xFF;
+    regs[3] = raw.temperature & 0xFF;
+    regs[4] = (raw.temperature >> 8) & 0xFF;
+    regs[5] = (raw.temperature >> 16) & 0xFF;
+}
+
+static void benchSensorDriver(const std::vector<sim::RawSample>& raw) {
+    size_t count = raw.size();
+    std::vector<uint8_t> regs(count * BMP3_LEN_P_T_DATA);
+    for (size_t i = 0; i < count; ++i) {
+        sensorRegisters(raw[i], &regs[i * BMP3_LEN_P_T_DATA]);
+    }
+    std::vector<bmp3_uncomp_data> uncomp(count);
+    for (size_t i = 0; i < count; ++i) {
+        bmp3_internal_parse_sensor_data(&regs[i * BMP3_LEN_P_T_DATA], &uncomp[i]);
+    }
+    bmp3_calib_data calib;
+    bmp3_internal_parse_calib_data(sim::getCalibrationRegisters(), &calib);
+
+    bench("bmp3.parse_sensor_data", "micro", [&](uint64_t n) {
+        bmp3_uncomp_data out;
+        for (uint64_t i = 0; i < n; ++i) {
+            bmp3_internal_parse_sensor_data(&regs[(i % count) * BMP3_LEN_P_T_DATA], &out);
+            keep(out);
+        }
+    });
+
+    bench("bmp3.compensate_data", "micro", [&](uint64_t n) {
+        bmp3_data out;
+        for (uint64_t i = 0; i < n; ++i) {
+            bmp3_internal_compensate_data(BMP3_PRESS_TEMP, &uncomp[i % count], &out, &calib);
+            keep(out);
+        }
+    });
+
+    // A full FIFO of pressure and temperature frames, reported per frame
+    constexpr size_t FRAME_BYTES = 7;
+    constexpr size_t FIFO_FRAMES = 512 / FRAME_BYTES;
+    uint8_t fifoBuffer[FIFO_FRAMES * FRAME_BYTES];
+    for (size_t i = 0; i < FIFO_FRAMES; ++i) {
+        const sim::RawSample& sample = raw[i % count];
+        uint8_t* frame = &fifoBuffer[i * FRAME_BYTES];
+        frame[0] = BMP3_FIFO_TEMP_PRESS_FRAME;
+        frame[1] = sample.temperature & 0xFF;
+        frame[2] = (sample.temperature >> 8) & 0xFF;
+        frame[3] = (sample.temperature >> 16) & 0xFF;
+        frame[4] = sample.pressure & 0xFF;
+        frame[5] = (sample.pressure >> 8) & 0xFF;
+        frame[6] = (sample.pressure >> 16) & 0xFF;
+    }
+    bmp3_dev dev = {};
+    dev.calib_data = calib;
+    dev.intf_ptr = &dev;
+    dev.read = [](uint8_t, uint8_t*, uint32_t, void*) -> BMP3_INTF_RET_TYPE { return BMP3_OK; };
+    dev.write = [](uint8_t, const uint8_t*, uint32_t, void*) -> BMP3_INTF_RET_TYPE { return BMP3_OK; };
+    dev.delay_us = [](uint32_t, void*) {};
+    bench("bmp3_extract_fifo_data", "micro", [&](uint64_t n) {
+        bmp3_data frames[FIFO_FRAMES];
+        for (uint64_t i = 0; i < n; ++i) {
+            bmp3_fifo_data fifo = {};
+            fifo.buffer = fifoBuffer;
+            fifo.byte_count = sizeof(fifoBuffer);
+            bmp3_extract_fifo_data(frames, &fifo, &dev);
+            keep(frames);
+        }
+    }, FIFO_FRAMES);
+}
+
+static void benchAltitude(bmp390::BMP390& sensor) {
+    bench("BMP390::getAltitudeMeters", "micro", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            double altitude = sensor.getAltitudeMeters(101325.0 - static_cast<double>(i & 1023));
+            keep(altitude);
+        }
+    });
+
+    bench("pipeline::altitudeFeet", "micro", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            double altitude = pipeline::altitudeFeet(90000.0 + static_cast<double>(i & 1023), 101325.0);
+            keep(altitude);
+        }
+    });
+}
+
+static void benchDisplay(ht16k33::HT16K33& display) {
+    bench("HT16K33::displayNumber", "micro", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            display.displayNumber(static_cast<int>(i % 10000));
+            // displayNumber() only builds the frame; the clobber makes each
+            // one be built in full
+            keep(display.getFrame());
+        }
+    });
+}
+
+static void benchEvents() {
+    event::initEventQueue();
+    bench("event.queue_round_trip", "micro", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            event::queueEvent(event::Event(event::EventType::Timer, static_cast<int32_t>(i)));
+            event::Event evt = event::tryGetEvent();
+            keep(evt);
+        }
+    });
+}
+
+static void benchLogFormat(const std::vector<logformat::Record>& flight) {
+    size_t count = flight.size();
+    std::vector<uint8_t> stream(count * codec::MAX_SAMPLE_BYTES);
+    size_t streamBytes = 0;
+    {
+        codec::Encoder encoder;
+        for (const logformat::Record& record : flight) {
+            streamBytes += encoder.encode(record, &stream[streamBytes], stream.size() - streamBytes);
+        }
+    }
+
+    bench("codec.encode", "micro", [&](uint64_t n) {
+        codec::Encoder encoder;
+        uint8_t out[codec::MAX_SAMPLE_BYTES];
+        for (uint64_t i = 0; i < n; ++i) {
+            size_t used = encoder.encode(flight[i % count], out, sizeof(out));
+            keep(used);
+        }
+    });
+
+    bench("codec.decode", "micro", [&](uint64_t n) {
+        codec::Decoder decoder;
+        logformat::Record record;
+        size_t offset = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            if (offset >= streamBytes) {
+                decoder.reset();
+                offset = 0;
+            }
+            offset += decoder.decode(&stream[offset], streamBytes - offset, record);
+            keep(record);
+        }
+    });
+
+    uint8_t page[logformat::PAGE_SIZE];
+    memset(page, 0xA5, sizeof(page));
+    bench("crc32.page", "micro", [&](uint64_t n) {
+        uint32_t crc = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            crc = crc::crc32(page, sizeof(page), crc);
+        }
+        keep(crc);
+    });
+}
+
+// Acquisition -> estimate -> render, as the firmware's Altimeter mode does
+// on every timer tick, with the simulated sensor replaying a flight
+static void benchCycle(bmp390::BMP390& sensor, ht16k33::HT16K33& display,
+                       const std::vector<sim::RawSample>& raw) {
+    static const struct {
+        const char* name;
+        bmp390::Profile profile;
+    } PROFILES[] = {
+        {"cycle.standard", bmp390::Profile::Standard},
+        {"cycle.high_rate", bmp390::Profile::HighRate},
+        {"cycle.low_power", bmp390::Profile::LowPower},
+    };
+
+    for (const auto& entry : PROFILES) {
+        if (filter && !strstr(entry.name, filter)) {
+            continue;
+        }
+        sensor.begin(entry.profile);
+        pipeline::Pipeline pipe;
+        size_t count = raw.size();
+        bench(entry.name, "macro", [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                sim::setSensorSample(raw[i % count]);
+                pipeline::Output output = pipe.step(sensor, to_ms_since_boot(get_absolute_time()));
+                if (output.valid) {
+                    display.displayNumber(output.displayFeet);
+                    display.setColon(false);
+                    display.writeDisplay();
+                }
+                logger::service();
+            }
+        });
+    }
+}
+
+// Sensor start-up: chip ID, soft reset, calibration and settings
+static void benchSensorBegin(bmp390::BMP390& sensor) {
+    bench("sensor.begin", "macro", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            keep(sensor.begin(bmp390::Profile::Standard));
+        }
+    });
+}
+
+// Recorded samples through the replay source and the pipeline, no display
+static void benchReplay(const std::vector<logformat::Record>& flight) {
+    bench("replay.pipeline", "macro", [&](uint64_t n) {
+        replay::Options options;
+        options.loop = true;
+        replay::ReplaySource source(flight.data(), flight.size(), options);
+        pipeline::Pipeline pipe;
+        for (uint64_t i = 0; i < n; ++i) {
+            pipeline::Output output = pipe.step(source, source.getTimeMs());
+            keep(output.displayFeet);
+        }
+    });
+}
+
+// Rocket flights through the simulated sensor at the HighRate profile's
+// output data rate, timing the detector and reporting how long after each
+// event it was detected (the worst over several noise seeds)
+static void benchDetection(bmp390::BMP390& sensor) {
+    constexpr uint32_t FLIGHTS = 16;
+
+    trace::RocketProfile profile;
+    std::vector<logformat::Record> rocket = trace::syntheticRocket(profile);
+    std::vector<double> altitudes;
+    for (const logformat::Record& record : rocket) {
+        altitudes.push_back(pipeline::altitudeFeet(record.pressureCentiPa / 100.0, 101325.0));
+    }
+    bench("flightevents.update", "micro", [&](uint64_t n) {
+        flightevents::Detector detector;
+        for (uint64_t i = 0; i < n; ++i) {
+            keep(detector.update(i * profile.periodMs * 1000ull, altitudes[i % altitudes.size()]));
+        }
+    });
+
+    if (filter && !strstr("detect.rocket", filter)) {
+        return;
+    }
+    trace::RocketTimes truth = trace::rocketTimes(profile);
+    const double truthS[] = {0.0, truth.launch, truth.apogee, truth.landing};
+    const char* const names[] = {"", "launch", "apogee", "landing"};
+    double worstMs[4] = {-1e9, -1e9, -1e9, -1e9};
+    uint32_t missed = 0;
+
+    sensor.begin(bmp390::Profile::HighRate);
+    for (uint32_t flight = 0; flight < FLIGHTS; ++flight) {
+        profile.seed = flight + 1;
+        rocket = trace::syntheticRocket(profile);
+        pipeline::Pipeline pipe;
+        uint64_t startUs = sim::getTimeUs();
+        bool seen[4] = {};
+        for (const logformat::Record& record : rocket) {
+            sim::advanceUs(startUs + record.timeMs * 1000ull - sim::getTimeUs());
+            sim::setSensorSample(sim::rawForSample(record.pressureCentiPa / 100.0, 20.0));
+            pipeline::Output output = pipe.step(sensor, to_ms_since_boot(get_absolute_time()));
+            size_t index = static_cast<size_t>(output.flightEvent);
+            if (index != 0) {
+                double delayMs = (pipe.getLastDetection().detectedUs - startUs) / 1000.0 - truthS[index] * 1000.0;
+                worstMs[index] = std::max(worstMs[index], delayMs);
+                seen[index] = true;
+            }
+        }
+        missed += !seen[1] + !seen[2] + !seen[3];
+    }
+    sensor.begin(bmp390::Profile::Standard);
+
+    fprintf(stderr, "  %-34s", "detect.rocket worst delay");
+    for (size_t i = 1; i < 4; ++i) {
+        fprintf(stderr, " %s %.0f ms", names[i], worstMs[i]);
+    }
+    fprintf(stderr, " (%u flights, %u events missed)\n", FLIGHTS, missed);
+}
+
+// Pressure history fed at the Standard profile's data rate; the cascade into
+// the coarser levels is included in the per-sample cost
+static void benchHistory(const std::vector<logformat::Record>& flight) {
+    static history::History store;
+    bench("history.add", "micro", [&](uint64_t n) {
+        store.reset();
+        for (uint64_t i = 0; i < n; ++i) {
+            keep(store.add(static_cast<uint32_t>(i * 80), flight[i % flight.size()].pressureCentiPa / 100.0));
+        }
+    });
+}
+
+// The Hampel stage against the obvious version: copy the window, sort it for
+// the median, then sort the deviations for the MAD
+static void benchOutlier(const std::vector<logformat::Record>& flight) {
+    std::vector<double> pressures;
+    for (const logformat::Record& record : flight) {
+        pressures.push_back(record.pressureCentiPa / 100.0);
+    }
+    bench("outlier.hampel", "micro", [&](uint64_t n) {
+        outlier::Hampel filter;
+        for (uint64_t i = 0; i < n; ++i) {
+            keep(filter.filter(pressures[i % pressures.size()]));
+        }
+    });
+    bench("outlier.naive_sort", "micro", [&](uint64_t n) {
+        double ring[outlier::WINDOW] = {};
+        double sorted[outlier::WINDOW];
+        for (uint64_t i = 0; i < n; ++i) {
+            double value = pressures[i % pressures.size()];
+            ring[i % outlier::WINDOW] = value;
+            std::copy(ring, ring + outlier::WINDOW, sorted);
+            std::sort(sorted, sorted + outlier::WINDOW);
+            double median = sorted[outlier::WINDOW / 2];
+            for (double& entry : sorted) {
+                entry = fabs(entry - median);
+            }
+            std::sort(sorted, sorted + outlier::WINDOW);
+            double limit = std::max(outlier::THRESHOLD * outlier::MAD_TO_SIGMA * sorted[outlier::WINDOW / 2],
+                                    outlier::MIN_DEVIATION_PA);
+            keep(fabs(value - median) > limit ? median : value);
+        }
+    });
+}
+
+static void writeJson(FILE* out, const char* commit) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"suite\": \"pico-altimeter-bench\",\n");
+    fprintf(out, "  \"commit\": \"%s\",\n", commit);
+    fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf(out, "  \"repetitions\": %d,\n", REPETITIONS);
+    fprintf(out, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        fprintf(out,
+                "    {\"name\": \"%s\", \"kind\": \"%s\", \"iterations\": %llu, "
+                "\"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"ops_per_s\": %.0f}%s\n",
+                result.name.c_str(), result.kind, static_cast<unsigned long long>(result.iterations),
+                result.nsPerOp, result.minNsPerOp, result.nsPerOp > 0 ? 1e9 / result.nsPerOp : 0.0,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void usage() {
+    fprintf(stderr, "Usage: pico-altimeter-bench [--filter TEXT] [--min-time SECONDS] [--commit ID] [--out FILE]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* commit = BENCH_COMMIT;
+    const char* outPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--commit") && i + 1 < argc) {
+            commit = argv[++i];
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    logger::initLogger();
+    std::vector<logformat::Record> flight = trace::syntheticFlight();
+    std::vector<sim::RawSample> raw = makeRawFlight(flight, 1024);
+
+    ht16k33::HT16K33 display(i2c1);
+    display.begin();
+    bmp390::BMP390 sensor(i2c0, 0x77);
+    if (!sensor.begin() || !sensor.readSensor()) {
+        fprintf(stderr, "Simulated sensor failed to start\n");
+        return 1;
+    }
+
+    fprintf(stderr, "pico-altimeter-bench (%s)\n", commit);
+    benchSensorDriver(raw);
+    benchAltitude(sensor);
+    benchDisplay(display);
+    benchEvents();
+    benchLogFormat(flight);
+    benchSensorBegin(sensor);
+    benchCycle(sensor, display, raw);
+    benchReplay(flight);
+    benchDetection(sensor);
+    benchHistory(flight);
+    benchOutlier(flight);
+
+    FILE* out = stdout;
+    if (outPath) {
+        out = fopen(outPath, "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", outPath);
+            return 1;
+        }
+    }
+    writeJson(out, commit);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
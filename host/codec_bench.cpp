@@ -0,0 +1,120 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+//
+// Size and speed of the sample codec on recorded or synthetic traces.
+// Usage: codec-bench [trace.csv ...]
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "logformat.h"
+#include "samplecodec.h"
+#include "trace.h"
+
+// A double pressure, double temperature and a 64-bit timestamp
+constexpr double NAIVE_BYTES_PER_SAMPLE = 24.0;
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool sameRecord(const logformat::Record& a, const logformat::Record& b) {
+    return a.timeMs == b.timeMs && a.pressureCentiPa == b.pressureCentiPa &&
+           a.temperatureCentiC == b.temperatureCentiC && a.flags == b.flags;
+}
+
+static void benchTrace(const char* name, const std::vector<logformat::Record>& records) {
+    if (records.size() < 2) {
+        printf("%s: not enough samples\n", name);
+        return;
+    }
+    size_t count = records.size();
+
+    // Continuous stream, as used for telemetry
+    std::vector<uint8_t> stream(count * codec::MAX_SAMPLE_BYTES);
+    size_t streamBytes = 0;
+    int iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    do {
+        codec::Encoder encoder;
+        streamBytes = 0;
+        for (const logformat::Record& record : records) {
+            streamBytes += encoder.encode(record, stream.data() + streamBytes, stream.size() - streamBytes);
+        }
+        iterations++;
+    } while (secondsSince(start) < 0.5);
+    double encodeNs = secondsSince(start) * 1e9 / (double(iterations) * count);
+
+    std::vector<logformat::Record> decoded(count);
+    iterations = 0;
+    start = std::chrono::steady_clock::now();
+    do {
+        codec::Decoder decoder;
+        size_t offset = 0;
+        for (size_t i = 0; i < count; ++i) {
+            offset += decoder.decode(stream.data() + offset, streamBytes - offset, decoded[i]);
+        }
+        iterations++;
+    } while (secondsSince(start) < 0.5);
+    double decodeSeconds = secondsSince(start) / iterations;
+    double decodeNs = decodeSeconds * 1e9 / count;
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!sameRecord(records[i], decoded[i])) {
+            mismatches++;
+        }
+    }
+
+    // Flash pages, as written by the flight log (header and slack included)
+    size_t pages = 1;
+    size_t pageFill = 0;
+    codec::Encoder pageEncoder;
+    uint8_t payload[logformat::PAGE_PAYLOAD_SIZE];
+    for (const logformat::Record& record : records) {
+        size_t used = pageEncoder.encode(record, payload + pageFill, sizeof(payload) - pageFill);
+        if (used == 0) {
+            pages++;
+            pageFill = 0;
+            pageEncoder.reset();
+            used = pageEncoder.encode(record, payload, sizeof(payload));
+        }
+        pageFill += used;
+    }
+
+    double streamPerSample = double(streamBytes) / count;
+    double flashPerSample = double(pages * logformat::PAGE_SIZE) / count;
+    double periodMs = double(records.back().timeMs - records.front().timeMs) / (count - 1);
+    double minutesPerMB = (1024.0 * 1024.0 / flashPerSample) * periodMs / 60000.0;
+
+    printf("%s: %zu samples, %.1f ms period\n", name, count, periodMs);
+    printf("  naive record           %6.2f bytes/sample\n", NAIVE_BYTES_PER_SAMPLE);
+    printf("  raw flash record       %6.2f bytes/sample\n", double(sizeof(logformat::Record)));
+    printf("  codec stream           %6.2f bytes/sample\n", streamPerSample);
+    printf("  codec in flash pages   %6.2f bytes/sample (%.1fx naive, %.0f min/MB)\n",
+           flashPerSample, NAIVE_BYTES_PER_SAMPLE / flashPerSample, minutesPerMB);
+    printf("  encode %.1f ns/sample, decode %.1f ns/sample (%.0f MB/s)\n",
+           encodeNs, decodeNs, streamBytes / decodeSeconds / 1e6);
+    printf("  round trip %s\n", mismatches ? "FAILED" : "ok");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        trace::FlightProfile profile;
+        profile.periodMs = 20;
+        benchTrace("synthetic 50 Hz flight", trace::syntheticFlight(profile));
+        profile.periodMs = 250;
+        benchTrace("synthetic 4 Hz flight", trace::syntheticFlight(profile));
+        return 0;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::vector<logformat::Record> records;
+        if (!trace::loadCsv(argv[i], records)) {
+            fprintf(stderr, "Cannot read %s\n", argv[i]);
+            return 1;
+        }
+        benchTrace(argv[i], records);
+    }
+    return 0;
+}
@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+# (C) Alan Ludwig 2026, all rights reserved.
+#
+# Static RAM and worst-case stack report for a GCC build. Reads the object
+# files and the .ci call graphs (-fcallgraph-info=su) the compiler leaves next
+# to them, and prints
+#   - .data + .bss per module, so RAM growth shows up per change, and
+#   - the worst-case stack depth of each entry point (functions nothing calls
+#     directly: main, interrupt handlers, timer and driver callbacks).
+#
+# Indirect calls (callbacks, virtual functions) cannot be followed. Each one is
+# charged the deepest entry point other than main, itself computed the same
+# way, to a nesting depth of INDIRECT_NESTING; the "direct" column leaves them
+# out. Recursion and variable-sized frames are flagged rather than bounded.
+#
+# Usage: footprint.py --objects DIR [--nm NM] [--source-dir DIR] [--top N] [--out FILE]
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+RAM_TYPES = set("bBdDC")
+
+NODE_RE = re.compile(r'^node: \{ title: "([^"]+)" label: "([^"]*)"(.*)\}$')
+EDGE_RE = re.compile(r'^edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+GRAPH_RE = re.compile(r'^graph: \{ title: "([^"]+)"')
+FRAME_RE = re.compile(r"(\d+) bytes \(([a-z,]+)\)")
+
+INDIRECT = "__indirect_call"
+
+# Callback inside a virtual call inside a callback: sensor source -> driver ->
+# bus transfer
+INDIRECT_NESTING = 3
+
+
+def find_files(root, suffixes):
+    found = []
+    for directory, _, names in os.walk(root):
+        for name in names:
+            if name.endswith(suffixes):
+                found.append(os.path.join(directory, name))
+    return sorted(found)
+
+
+def module_name(path, objects_dir):
+    name = os.path.relpath(path, objects_dir)
+    for suffix in (".obj", ".o"):
+        if name.endswith(suffix):
+            name = name[: -len(suffix)]
+    return name
+
+
+def ram_by_module(objects, nm, objects_dir):
+    sizes = {}
+    for path in objects:
+        try:
+            output = subprocess.run([nm, "-S", "--defined-only", path], check=True,
+                                    capture_output=True, text=True).stdout
+        except (OSError, subprocess.CalledProcessError) as error:
+            print(f"footprint: cannot read {path}: {error}", file=sys.stderr)
+            continue
+        total = 0
+        for line in output.splitlines():
+            fields = line.split()
+            if len(fields) == 4 and fields[2] in RAM_TYPES:
+                total += int(fields[1], 16)
+        if total:
+            sizes[module_name(path, objects_dir)] = total
+    return sizes
+
+
+class Function:
+    def __init__(self, name, source, frame, qualifier):
+        self.name = name
+        self.source = source
+        self.frame = frame
+        self.dynamic = "dynamic" in qualifier and "bounded" not in qualifier
+        self.calls = []
+        self.indirect = False
+        self.called = False
+
+
+def parse_call_graphs(paths):
+    # Local (static) functions can share a name across files, so definitions
+    # are keyed by (file, name) and calls resolve within the file first
+    by_file = {}
+    by_name = {}
+    pending = []
+    for path in paths:
+        source = path
+        with open(path, encoding="utf-8", errors="replace") as graph:
+            for line in graph:
+                line = line.strip()
+                match = GRAPH_RE.match(line)
+                if match:
+                    source = match.group(1)
+                    continue
+                match = NODE_RE.match(line)
+                if match:
+                    title, label = match.group(1), match.group(2)
+                    frame = FRAME_RE.search(label)
+                    if not frame:
+                        continue  # External declaration or placeholder
+                    name = label.split("\\n")[0]
+                    if "(" not in name:
+                        name = title  # Compiler-generated, e.g. static initializers
+                    function = Function(name, source, int(frame.group(1)), frame.group(2))
+                    by_file[(source, title)] = function
+                    by_name.setdefault(title, function)
+                    continue
+                match = EDGE_RE.match(line)
+                if match:
+                    pending.append((source, match.group(1), match.group(2)))
+
+    for source, caller_title, callee_title in pending:
+        caller = by_file.get((source, caller_title))
+        if not caller:
+            continue
+        if callee_title == INDIRECT:
+            caller.indirect = True
+            continue
+        callee = by_file.get((source, callee_title)) or by_name.get(callee_title)
+        if callee:
+            if callee not in caller.calls:
+                caller.calls.append(callee)
+            if callee is not caller:
+                callee.called = True
+    return list(by_file.values())
+
+
+class Depth:
+    def __init__(self, indirect_cost):
+        self.indirect_cost = indirect_cost
+        self.memo = {}
+
+    # Depth with indirect calls charged the deepest candidate target,
+    # nesting levels deep
+    @staticmethod
+    def nested(candidates, levels):
+        depth = Depth(0)
+        for _ in range(levels):
+            cost = max((depth.of(function)[0] for function in candidates), default=0)
+            depth = Depth(cost)
+        return depth
+
+    # Returns (bytes, recursive, dynamic, indirect)
+    def of(self, function, active=None):
+        if function in self.memo:
+            return self.memo[function]
+        active = active or set()
+        if function in active:
+            return (0, True, False, False)
+        active.add(function)
+        deepest = self.indirect_cost if function.indirect else 0
+        recursive = False
+        dynamic = function.dynamic
+        indirect = function.indirect
+        for callee in function.calls:
+            depth, callee_recursive, callee_dynamic, callee_indirect = self.of(callee, active)
+            deepest = max(deepest, depth)
+            recursive |= callee_recursive
+            dynamic |= callee_dynamic
+            indirect |= callee_indirect
+        active.discard(function)
+        result = (function.frame + deepest, recursive, dynamic, indirect)
+        if not recursive:
+            self.memo[function] = result
+        return result
+
+
+def flags(recursive, dynamic, indirect):
+    notes = []
+    if indirect:
+        notes.append("indirect")
+    if dynamic:
+        notes.append("dynamic")
+    if recursive:
+        notes.append("recursive")
+    return ", ".join(notes)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-module RAM and worst-case stack report")
+    parser.add_argument("--objects", required=True, help="directory holding the objects and .ci files")
+    parser.add_argument("--nm", default="nm", help="nm for the target toolchain")
+    parser.add_argument("--source-dir", help="project sources; entry points outside it are summarized")
+    parser.add_argument("--top", type=int, default=20, help="entry points to list")
+    parser.add_argument("--out", help="write the report here as well as to stdout")
+    args = parser.parse_args()
+
+    lines = []
+    objects = find_files(args.objects, (".obj", ".o"))
+    sizes = ram_by_module(objects, args.nm, args.objects)
+    source_dir = os.path.realpath(args.source_dir) if args.source_dir else None
+
+    def is_project(path):
+        if not source_dir:
+            return True
+        real = os.path.realpath(path)
+        return real.startswith(source_dir + os.sep) and "/_deps/" not in real
+
+    # Project sources compile to objects named after them; SDK objects carry
+    # the SDK's path
+    project_ram = {name: size for name, size in sizes.items()
+                   if not source_dir or os.path.isfile(os.path.join(source_dir, name))}
+    lines.append("Static RAM (.data + .bss) by module, bytes")
+    for name, size in sorted(sizes.items(), key=lambda item: -item[1]):
+        if name in project_ram:
+            lines.append(f"  {os.path.basename(name):<32} {size:>8}")
+    library_ram = sum(size for name, size in sizes.items() if name not in project_ram)
+    lines.append(f"  {'(SDK and libraries)':<32} {library_ram:>8}")
+    lines.append(f"  {'total':<32} {sum(sizes.values()):>8}")
+
+    functions = parse_call_graphs(find_files(args.objects, (".ci",)))
+    if not functions:
+        lines.append("")
+        lines.append("No call graph found (build with -fcallgraph-info=su)")
+    else:
+        roots = [function for function in functions if not function.called]
+        candidates = [function for function in roots if function.name != "int main()"]
+        direct = Depth(0)
+        bounded = Depth.nested(candidates, INDIRECT_NESTING)
+
+        # Inline functions are emitted in every file that uses them; keep one
+        rows = {}
+        for function in roots:
+            depth, recursive, dynamic, indirect = bounded.of(function)
+            row = (depth, direct.of(function)[0], function, flags(recursive, dynamic, indirect))
+            if function.name not in rows or rows[function.name][0] < depth:
+                rows[function.name] = row
+        ordered = sorted(rows.values(), key=lambda row: (row[2].name != "int main()", -row[0]))
+
+        lines.append("")
+        lines.append(f"Worst-case stack by entry point, bytes (deepest {args.top} of {len(ordered)};"
+                     f" indirect calls charged {bounded.indirect_cost})")
+        lines.append(f"  {'entry point':<56} {'bound':>7} {'direct':>7}  notes")
+        for depth, direct_depth, function, note in ordered[: args.top]:
+            name = function.name if len(function.name) <= 56 else function.name[:53] + "..."
+            library = "" if is_project(function.source) else " (library)"
+            lines.append(f"  {name:<56} {depth:>7} {direct_depth:>7}  {note}{library}")
+
+    report = "\n".join(lines) + "\n"
+    sys.stdout.write(report)
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as out:
+            out.write(report)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
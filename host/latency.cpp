@@ -0,0 +1,334 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+//
+// Latency from a pressure change to the display, measured on the host with
+// the real sensor driver and pipeline against the simulated sensor
+// (host/sim), which converts on its own schedule as the part does in normal
+// mode. Each trial settles the sensor, steps the true pressure at a random
+// moment and timestamps the first point each stage shows the change (half
+// the step): the sensor's conversion, the read that brings it in, its
+// compensation, the pipeline's estimate, the frame that draws it and that
+// frame's write to the display completing. Reads follow the firmware's
+// Altimeter mode: a timer at the sensor's period (or the display period, if
+// slower), each display period starting a frame of the output just
+// estimated, and optionally the phase lock. The marks are the
+// ones PICO_ALTIMETER_PROBES puts on GPIO on the target (probe.h). The
+// overlap column is the share of the sensor reads' bus time during which a
+// frame was going out on the other bus, as i2cbus reports it on the target.
+//
+// CPU work takes no simulated time, so read and compensation coincide here;
+// on the target the probe pins (against the sensor's INT pin for the
+// conversion) time them.
+//
+// Usage: pico-altimeter-latency [--trials N] [--csv]
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include "bmp390.h"
+#include "hardware/i2c.h"
+#include "ht16k33.h"
+#include "phaselock.h"
+#include "pipeline.h"
+#include "probe.h"
+#include "sim.h"
+
+extern "C" {
+#include "bmp3_defs.h"
+}
+
+constexpr double BASE_PA = 101325.0;
+constexpr double TEMPERATURE_C = 20.0;
+
+// A drop of 120 Pa, about 1000 ft up near sea level: far outside the
+// outlier filter's threshold, so that filter delays it rather than hiding it
+constexpr double STEP_PA = -120.0;
+
+// Give up on a trial this long after the step
+constexpr uint64_t TIMEOUT_US = 30000000;
+
+constexpr uint32_t I2C_BAUD_HZ = 100000;
+
+// Where the change is timed
+enum Point : size_t {
+    CONVERSION,
+    READ,
+    COMPENSATE,
+    ESTIMATE,
+    RENDER,
+    FLUSH,
+    STAGES
+};
+
+static const char* const STAGE_NAMES[STAGES] = {"conversion", "read", "compensate", "estimate", "render", "flush"};
+
+// The trial in progress, for the hooks
+static struct {
+    bmp390::BMP390* sensor;
+    bool stepped;
+    uint64_t stepUs;
+    uint64_t readUs;            // Last Read mark
+    uint64_t reachedUs[STAGES]; // 0 until the change reaches the stage
+} trial;
+
+static void reach(Point point, uint64_t timeUs) {
+    if (trial.stepped && trial.reachedUs[point] == 0) {
+        trial.reachedUs[point] = timeUs;
+    }
+}
+
+static bool pressureChanged(double pressurePa) {
+    return pressurePa <= BASE_PA + STEP_PA / 2;
+}
+
+static void onConversion(uint64_t timeUs, double pressurePa) {
+    if (trial.stepped && timeUs >= trial.stepUs && pressureChanged(pressurePa)) {
+        reach(CONVERSION, timeUs);
+    }
+}
+
+// The drivers' probe marks, recorded against simulated time
+namespace probe {
+
+void init() {
+}
+
+void mark(Stage stage) {
+    if (stage == Stage::Read) {
+        trial.readUs = sim::getTimeUs();
+    } else if (stage == Stage::Compensate && pressureChanged(trial.sensor->getPressure())) {
+        reach(READ, trial.readUs);
+        reach(COMPENSATE, sim::getTimeUs());
+    }
+}
+
+}  // namespace probe
+
+struct Config {
+    bmp390::Profile profile;
+    bool iir;                   // The profile's IIR filter, or none
+    uint32_t displayPeriodMs;
+    bool rejectingOutliers;
+    bool locked;
+};
+
+struct Summary {
+    double sumMs[STAGES];
+    double maxMs[STAGES];
+    uint32_t reached[STAGES];
+    uint32_t trials;
+    uint64_t readUs;            // Bus time of the sensor reads
+    uint64_t overlapUs;         // Of which a frame was going out too
+};
+
+static const char* profileName(bmp390::Profile profile) {
+    switch (profile) {
+        case bmp390::Profile::Standard: return "standard";
+        case bmp390::Profile::HighRate: return "high-rate";
+        case bmp390::Profile::LowPower: return "low-power";
+        default: return "?";
+    }
+}
+
+// IIR coefficient the sensor is running with, from its CONFIG register
+static uint32_t readIirCoefficient() {
+    uint8_t reg = BMP3_REG_CONFIG;
+    uint8_t config = 0;
+    i2c_write_blocking(i2c0, BMP3_ADDR_I2C_SEC, &reg, 1, true);
+    i2c_read_blocking(i2c0, BMP3_ADDR_I2C_SEC, &config, 1, false);
+    uint32_t code = (config & BMP3_IIR_FILTER_MSK) >> BMP3_IIR_FILTER_POS;
+    return (1u << code) - 1;
+}
+
+// Run one trial of config: the sample timer starts phaseUs (within a sample
+// period) after the sensor and the step comes offsetUs into the measured
+// part. Returns the IIR coefficient in use.
+static uint32_t runTrial(const Config& config, uint64_t phaseUs, uint64_t offsetUs, Summary& summary) {
+    trial = {};
+    bmp390::BMP390 sensor(i2c0, BMP3_ADDR_I2C_SEC);
+    trial.sensor = &sensor;
+    sim::setTruePressure(BASE_PA, TEMPERATURE_C);
+    if (!sensor.begin(config.profile)) {
+        fprintf(stderr, "sensor did not start\n");
+        exit(1);
+    }
+    if (!config.iir) {
+        uint8_t off[] = {BMP3_REG_CONFIG, 0};
+        i2c_write_blocking(i2c0, BMP3_ADDR_I2C_SEC, off, sizeof(off), false);
+    }
+    uint32_t iir = readIirCoefficient();
+
+    pipeline::Pipeline pipe;
+    pipe.setRejectingOutliers(config.rejectingOutliers);
+    double thresholdFeet = pipeline::altitudeFeet(BASE_PA + STEP_PA / 2, pipe.getSeaLevelPressure());
+
+    uint32_t sensorPeriodMs = bmp390::outputPeriodUs(config.profile) / 1000;
+    uint32_t samplePeriodMs = sensorPeriodMs < config.displayPeriodMs ? sensorPeriodMs : config.displayPeriodMs;
+    uint32_t samplesPerPeriod = (config.displayPeriodMs + samplePeriodMs / 2) / samplePeriodMs;
+    samplesPerPeriod = samplesPerPeriod > 0 ? samplesPerPeriod : 1;
+    uint64_t samplePeriodUs = samplePeriodMs * 1000ull;
+    bool locking = config.locked && samplePeriodMs == sensorPeriodMs;
+    uint64_t sensorPeriodUs = bmp390::outputPeriodUs(config.profile);
+    const phaselock::PhaseLock& lock = sensor.getPhaseLock();
+
+    // Settle the filters (the outlier window, the sensor's IIR at its
+    // largest coefficient) and the phase lock before the step
+    uint64_t settleUs = 16 * (samplePeriodUs > sensorPeriodUs ? samplePeriodUs : sensorPeriodUs);
+    uint64_t stepUs = sim::getTimeUs() + settleUs + offsetUs;
+
+    uint32_t sampleCount = 0;
+    uint64_t frameStartUs = 0;
+    uint64_t frameEndUs = 0;
+    uint64_t tickUs = sim::getTimeUs() + phaseUs % samplePeriodUs;
+    while (trial.reachedUs[FLUSH] == 0 && tickUs < stepUs + TIMEOUT_US) {
+        if (!trial.stepped && stepUs <= tickUs) {
+            sim::advanceUs(stepUs - sim::getTimeUs());
+            sim::setTruePressure(BASE_PA + STEP_PA, TEMPERATURE_C);
+            trial.stepped = true;
+            trial.stepUs = stepUs;
+        }
+        sim::advanceUs(tickUs - sim::getTimeUs());
+
+        uint64_t readStartUs = sim::getTimeUs();
+        pipeline::Output latest = pipe.step(sensor, static_cast<uint32_t>(sim::getTimeUs() / 1000));
+        uint64_t readEndUs = sim::getTimeUs();
+        summary.readUs += readEndUs - readStartUs;
+        uint64_t overlapStartUs = readStartUs > frameStartUs ? readStartUs : frameStartUs;
+        uint64_t overlapEndUs = readEndUs < frameEndUs ? readEndUs : frameEndUs;
+        summary.overlapUs += overlapEndUs > overlapStartUs ? overlapEndUs - overlapStartUs : 0;
+        bool reached = latest.valid && latest.altitudeFeet >= thresholdFeet;
+        if (reached) {
+            reach(ESTIMATE, sim::getTimeUs());
+        }
+
+        // Once a display period the frame of this output is started; it
+        // goes out on i2c1 while the firmware logs
+        if (sampleCount++ % samplesPerPeriod == 0) {
+            frameStartUs = sim::getTimeUs();
+            frameEndUs = frameStartUs + sim::transferUs(ht16k33::FRAME_BYTES);
+            if (reached) {
+                reach(RENDER, frameStartUs);
+                reach(FLUSH, frameEndUs);
+            }
+        }
+
+        uint64_t nextUs = tickUs + samplePeriodUs;
+        if (locking) {
+            uint64_t ticks = sensor.getSensorTicks();
+            int64_t latencyUs = static_cast<int64_t>(sensor.toMcuUs(ticks) - tickUs);
+            if (latencyUs >= 0 && latencyUs <= static_cast<int64_t>(samplePeriodUs / 4)) {
+                nextUs = sensor.toMcuUs(lock.getNextReadTicks()) - latencyUs;
+            }
+        }
+        tickUs = nextUs > sim::getTimeUs() ? nextUs : sim::getTimeUs();
+    }
+
+    summary.trials++;
+    for (size_t s = 0; s < STAGES; ++s) {
+        if (trial.reachedUs[s] == 0) {
+            continue;
+        }
+        double ms = (trial.reachedUs[s] - trial.stepUs) / 1000.0;
+        summary.sumMs[s] += ms;
+        summary.maxMs[s] = ms > summary.maxMs[s] ? ms : summary.maxMs[s];
+        summary.reached[s]++;
+    }
+    return iir;
+}
+
+int main(int argc, char** argv) {
+    uint32_t trials = 32;
+    bool csv = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--trials") == 0 && i + 1 < argc) {
+            trials = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--trials N] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    trials = trials > 0 ? trials : 1;
+
+    sim::setI2cBaud(I2C_BAUD_HZ);
+    sim::setConversionHook(onConversion);
+
+    if (csv) {
+        printf("profile,odr_hz,iir,display_period_ms,outlier_filter,phase_lock,trials");
+        for (const char* name : STAGE_NAMES) {
+            printf(",%s_mean_ms,%s_max_ms", name, name);
+        }
+        printf(",overlap_pct\n");
+    } else {
+        printf("Step of %.0f Pa to the display, mean/max ms over %u trials (I2C at %u kHz)\n\n",
+               STEP_PA, trials, I2C_BAUD_HZ / 1000);
+        printf("%-10s %5s %4s %6s %7s %4s", "profile", "ODR", "IIR", "period", "outlier", "lock");
+        for (const char* name : STAGE_NAMES) {
+            printf(" %15s", name);
+        }
+        printf(" %7s\n", "overlap");
+    }
+
+    // The same step times for every configuration
+    std::mt19937_64 random(1);
+    const bmp390::Profile PROFILES[] = {bmp390::Profile::HighRate, bmp390::Profile::Standard, bmp390::Profile::LowPower};
+    const uint32_t DISPLAY_PERIODS_MS[] = {100, 250, 1000};
+    for (bmp390::Profile profile : PROFILES) {
+        uint32_t coefficient = 0;
+        for (bool iir : {true, false}) {
+            if (!iir && coefficient == 0) {
+                continue;                   // The profile has no IIR filter to turn off
+            }
+            for (uint32_t period : DISPLAY_PERIODS_MS) {
+                for (bool rejecting : {true, false}) {
+                    for (bool locked : {false, true}) {
+                        uint32_t sensorPeriodMs = bmp390::outputPeriodUs(profile) / 1000;
+                        if (locked && sensorPeriodMs > period) {
+                            continue;       // Sampled at the display period: nothing to lock to
+                        }
+                        Config config = {profile, iir, period, rejecting, locked};
+                        Summary summary = {};
+                        random.seed(1);
+                        uint64_t spanUs = bmp390::outputPeriodUs(profile) + period * 1000ull;
+                        for (uint32_t t = 0; t < trials; ++t) {
+                            uint64_t phaseUs = random();
+                            coefficient = runTrial(config, phaseUs, random() % spanUs, summary);
+                        }
+
+                        double odrHz = 1e6 / bmp390::outputPeriodUs(profile);
+                        if (csv) {
+                            printf("%s,%.2f,%u,%u,%d,%d,%u", profileName(profile), odrHz, coefficient, period,
+                                   rejecting, locked, summary.trials);
+                        } else {
+                            printf("%-10s %5.1f %4u %6u %7s %4s", profileName(profile), odrHz, coefficient, period,
+                                   rejecting ? "on" : "off", locked ? "on" : "off");
+                        }
+                        for (size_t s = 0; s < STAGES; ++s) {
+                            if (summary.reached[s] < summary.trials) {
+                                if (csv) {
+                                    printf(",,");
+                                } else {
+                                    printf(" %15s", "missed");
+                                }
+                                continue;
+                            }
+                            double mean = summary.sumMs[s] / summary.trials;
+                            if (csv) {
+                                printf(",%.2f,%.2f", mean, summary.maxMs[s]);
+                            } else {
+                                char cell[32];
+                                snprintf(cell, sizeof(cell), "%.1f/%.1f", mean, summary.maxMs[s]);
+                                printf(" %15s", cell);
+                            }
+                        }
+                        double overlap = summary.readUs ? 100.0 * summary.overlapUs / summary.readUs : 0.0;
+                        printf(csv ? ",%.1f\n" : " %6.1f%%\n", overlap);
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
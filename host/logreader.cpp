@@ -0,0 +1,139 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "logreader.h"
+#include "samplecodec.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace logreader {
+
+using logformat::PAGE_SIZE;
+using logformat::PageHeader;
+
+// Upper bound on records in a page (one tag byte per sample at best)
+constexpr size_t MAX_PAGE_RECORDS = logformat::PAGE_PAYLOAD_SIZE;
+
+ReadStats readFlashDump(const uint8_t* data, size_t size, const Visitor& visit) {
+    ReadStats stats;
+    stats.bytes = size;
+
+    // Order pages by sequence; in a wrapped log the oldest page sits
+    // somewhere in the middle of the dump
+    struct Entry {
+        uint32_t sequence;
+        uint32_t page;
+    };
+    std::vector<Entry> order;
+    size_t pages = size / PAGE_SIZE;
+    order.reserve(pages);
+    for (size_t i = 0; i < pages; ++i) {
+        PageHeader header;
+        memcpy(&header, data + i * PAGE_SIZE, sizeof(header));
+        if (header.magic == logformat::PAGE_MAGIC) {
+            order.push_back({header.sequence, static_cast<uint32_t>(i)});
+        }
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const Entry& a, const Entry& b) { return a.sequence < b.sequence; });
+
+    logformat::Record records[MAX_PAGE_RECORDS];
+    for (const Entry& entry : order) {
+        const uint8_t* page = data + static_cast<size_t>(entry.page) * PAGE_SIZE;
+        if (!logformat::isValidPage(page)) {
+            stats.corruptPages++;
+            continue;
+        }
+        const PageHeader* header = logformat::getHeader(page);
+        size_t count = logformat::readRecords(page, records, MAX_PAGE_RECORDS);
+
+        PageInfo info = {header->session, header->sequence, header->seaLevelCentiPa};
+        visit(info, records, count);
+        stats.validPages++;
+        stats.records += count;
+    }
+    return stats;
+}
+
+ReadStats readStream(const uint8_t* data, size_t size, const Visitor& visit) {
+    ReadStats stats;
+    stats.bytes = size;
+
+    // Decode in batches so the visitor cost is amortised like for pages
+    constexpr size_t BATCH = 256;
+    logformat::Record records[BATCH];
+    size_t count = 0;
+    PageInfo info = {0, 0, 0};
+
+    codec::Decoder decoder;
+    size_t offset = 0;
+    while (offset < size) {
+        size_t used = decoder.decode(data + offset, size - offset, records[count]);
+        if (used == 0) {
+            // Corrupt or truncated: wait for the next keyframe
+            decoder.reset();
+            offset++;
+            stats.resyncs++;
+            continue;
+        }
+        offset += used;
+        if (++count == BATCH) {
+            visit(info, records, count);
+            stats.records += count;
+            info.sequence++;
+            count = 0;
+        }
+    }
+    if (count > 0) {
+        visit(info, records, count);
+        stats.records += count;
+    }
+    return stats;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const char* path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+    madvise(mapping, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const uint8_t*>(mapping);
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) {
+        munmap(const_cast<uint8_t*>(bytes), length);
+    }
+    bytes = nullptr;
+    length = 0;
+}
+
+}  // namespace logreader
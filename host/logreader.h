@@ -0,0 +1,57 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "logformat.h"
+
+// Readers for flight log flash dumps and raw telemetry captures.
+namespace logreader {
+
+// Context shared by a batch of records (one flash page)
+struct PageInfo {
+    uint16_t session;
+    uint32_t sequence;
+    uint32_t seaLevelCentiPa;    // 0 if unknown (telemetry streams)
+};
+
+using Visitor = std::function<void(const PageInfo& page, const logformat::Record* records, size_t count)>;
+
+struct ReadStats {
+    size_t bytes = 0;
+    size_t validPages = 0;
+    size_t corruptPages = 0;     // Had the page magic but failed the CRC
+    size_t records = 0;
+    size_t resyncs = 0;          // Stream positions skipped to find a keyframe
+};
+
+// Visit every record of a flash dump (whole flash or just the log region),
+// oldest page first. A header-only pass orders the pages, then each page is
+// checked and decoded exactly once.
+ReadStats readFlashDump(const uint8_t* data, size_t size, const Visitor& visit);
+
+// Visit every record of a raw codec stream (telemetry capture), resyncing on
+// the next keyframe after corruption
+ReadStats readStream(const uint8_t* data, size_t size, const Visitor& visit);
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const char* path);
+    void close();
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+};
+
+}  // namespace logreader
@@ -0,0 +1,620 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+//
+// Replays recorded flights through the firmware's altitude pipeline. The
+// outputs can be captured as CSV so the effect of a filter change is a diff,
+// and without capture the run reports pipeline throughput.
+//
+// Usage: pico-altimeter-replay [options] [input]
+//   --csv-in        input is a CSV trace rather than a flash dump
+//   --synthetic     replay a synthetic flight instead of an input file
+//   --rocket        replay a synthetic rocket flight instead of an input file
+//   --seed N        noise seed for --synthetic and --rocket (default 1)
+//   --realtime      deliver samples at their recorded rate, reading the
+//                   source every display period like the firmware does
+//   --period MS     display period for --realtime (default 250)
+//   --qnh PA        sea level pressure when the input has none (default 101325)
+//   --out FILE      write the pipeline outputs as CSV
+//   --vsi-report    take a sample every --sample-period, as the firmware
+//                   feeds the estimator, and report the vertical speed's
+//                   noise and delay against a reference (the truth for
+//                   --synthetic, else a centred straight-line fit to the
+//                   altitude)
+//   --sample-period MS  sample period for --vsi-report (default 80, the
+//                   Standard profile's data rate, at which the Altimeter
+//                   and VSI modes sample; 20 for HighRate)
+//   --events        report the launch, apogee and landing detections of
+//                   each flight and how long after the event each came
+//                   (against the truth for --rocket, else against the
+//                   event located in the whole recording after the fact)
+//   --capture       run event capture on every sample and report the flight
+//                   log bytes it costs, with regular logging every --period,
+//                   against logging every sample
+//   --pre MS        pre-trigger window for --capture (default 5000)
+//   --post MS       post-trigger window for --capture (default 10000)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "capture.h"
+#include "config.h"
+#include "logreader.h"
+#include "pipeline.h"
+#include "replay.h"
+#include "samplecodec.h"
+#include "trace.h"
+
+static std::chrono::steady_clock::time_point g_start = std::chrono::steady_clock::now();
+
+static uint32_t millisSinceStart() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::steady_clock::now() - g_start).count());
+}
+
+static void usage() {
+    fprintf(stderr, "Usage: pico-altimeter-replay [--csv-in | --synthetic] [--realtime] [--period MS] "
+                    "[--qnh PA] [--seed N] [--out FILE] [--vsi-report] [--sample-period MS] [--events] [--capture] [--pre MS] [--post MS] [input]\n");
+    fprintf(stderr, "       pico-altimeter-replay --rocket [options]\n");
+}
+
+// The estimator's default sample period in --vsi-report: the Standard
+// sensor profile's output period, which Altimeter and VSI sample at
+constexpr uint32_t VSI_SAMPLE_PERIOD_MS = 80;
+
+// Half width of the centred fit used as the reference vertical speed. Being
+// centred it has no delay; being wide it has little noise, at the cost of
+// rounding off the corners of the profile.
+constexpr double REFERENCE_HALF_WINDOW_S = 3.0;
+
+// Samples whose reference has stayed below this for SETTLE_S are level
+// flight, where the noise is measured
+constexpr double LEVEL_FEET_PER_MINUTE = 20.0;
+constexpr double SETTLE_S = 10.0;
+
+// Delays searched when aligning the estimate with the reference
+constexpr double MAX_DELAY_S = 5.0;
+constexpr double DELAY_STEP_S = 0.01;
+
+struct VsiSample {
+    double seconds;          // Sample time
+    double pressureFeet;     // Pressure altitude (standard sea level)
+    double feetPerMinute;    // Pipeline estimate
+    double referenceFpm;     // Filled in by the report
+};
+
+// Slope of the least squares line through the samples within halfWindow of
+// each one, in feet per minute; NAN where the window runs off either end
+static void centredFit(std::vector<VsiSample>& samples, double halfWindow) {
+    size_t first = 0;
+    size_t last = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        double centre = samples[i].seconds;
+        while (samples[first].seconds < centre - halfWindow) {
+            first++;
+        }
+        while (last + 1 < samples.size() && samples[last + 1].seconds <= centre + halfWindow) {
+            last++;
+        }
+        if (first == 0 || last + 1 == samples.size()) {
+            samples[i].referenceFpm = NAN;
+            continue;
+        }
+        // Times relative to the centre, so the sums stay well conditioned
+        double st = 0, sh = 0, stt = 0, sth = 0;
+        double n = static_cast<double>(last - first + 1);
+        for (size_t j = first; j <= last; ++j) {
+            double t = samples[j].seconds - centre;
+            st += t;
+            sh += samples[j].pressureFeet;
+            stt += t * t;
+            sth += t * samples[j].pressureFeet;
+        }
+        double denominator = n * stt - st * st;
+        samples[i].referenceFpm = denominator > 0 ? (n * sth - st * sh) / denominator * 60.0 : NAN;
+    }
+}
+
+// Reference at time t, linearly interpolated; NAN outside the samples
+static double referenceAt(const std::vector<VsiSample>& samples, double t) {
+    auto after = std::lower_bound(samples.begin(), samples.end(), t,
+                                  [](const VsiSample& s, double time) { return s.seconds < time; });
+    if (after == samples.begin() || after == samples.end()) {
+        return NAN;
+    }
+    auto before = after - 1;
+    double span = after->seconds - before->seconds;
+    double f = span > 0 ? (t - before->seconds) / span : 0.0;
+    return before->referenceFpm + f * (after->referenceFpm - before->referenceFpm);
+}
+
+// Events in the recording, located with the whole of it to hand
+constexpr double PAD_WINDOW_S = 5.0;            // Level before a launch, after a landing
+constexpr double EVENT_MARGIN_S = 1.0;          // Kept clear of the detection itself
+constexpr double SETTLED_MIN_FEET = 1.0;        // Least tolerance for "at the level"
+constexpr size_t SMOOTH_HALF_SAMPLES = 5;       // Centred average for apogee and landing
+
+static const char* const EVENT_NAMES[] = {"none", "launch", "apogee", "landing"};
+
+struct Level {
+    double mean;
+    double tolerance;           // Three sigma, at least SETTLED_MIN_FEET
+};
+
+// Altitude level over [from, to)
+static Level levelBetween(const std::vector<VsiSample>& samples, double from, double to) {
+    double sum = 0, sumSquares = 0;
+    size_t count = 0;
+    for (const VsiSample& s : samples) {
+        if (s.seconds >= from && s.seconds < to) {
+            sum += s.pressureFeet;
+            sumSquares += s.pressureFeet * s.pressureFeet;
+            count++;
+        }
+    }
+    if (count == 0) {
+        return Level{NAN, NAN};
+    }
+    double mean = sum / count;
+    double sigma = sqrt(std::max(0.0, sumSquares / count - mean * mean));
+    return Level{mean, std::max(SETTLED_MIN_FEET, 3.0 * sigma)};
+}
+
+static double smoothedFeet(const std::vector<VsiSample>& samples, size_t i) {
+    size_t first = i > SMOOTH_HALF_SAMPLES ? i - SMOOTH_HALF_SAMPLES : 0;
+    size_t last = std::min(samples.size() - 1, i + SMOOTH_HALF_SAMPLES);
+    double sum = 0;
+    for (size_t j = first; j <= last; ++j) {
+        sum += samples[j].pressureFeet;
+    }
+    return sum / (last - first + 1);
+}
+
+// When the event detected at detectedS happened, after the fact: the last
+// sample at pad level before a launch, the highest point for an apogee (the
+// search starts at previousS), the first sample at the final level for a
+// landing. NAN if it cannot be found.
+static double locateEvent(const std::vector<VsiSample>& samples, flightevents::Event event, double detectedS,
+                          double previousS) {
+    switch (event) {
+        case flightevents::Event::Launch: {
+            Level pad = levelBetween(samples, detectedS - EVENT_MARGIN_S - PAD_WINDOW_S, detectedS - EVENT_MARGIN_S);
+            double at = NAN;
+            for (const VsiSample& s : samples) {
+                if (s.seconds > detectedS) {
+                    break;
+                }
+                if (s.pressureFeet <= pad.mean + pad.tolerance) {
+                    at = s.seconds;
+                }
+            }
+            return at;
+        }
+        case flightevents::Event::Apogee: {
+            double at = NAN;
+            double highest = -INFINITY;
+            for (size_t i = 0; i < samples.size(); ++i) {
+                if (samples[i].seconds < previousS) {
+                    continue;
+                }
+                if (samples[i].seconds > detectedS + PAD_WINDOW_S) {
+                    break;
+                }
+                double feet = smoothedFeet(samples, i);
+                if (feet > highest) {
+                    highest = feet;
+                    at = samples[i].seconds;
+                }
+            }
+            return at;
+        }
+        case flightevents::Event::Landing: {
+            Level ground = levelBetween(samples, detectedS, detectedS + PAD_WINDOW_S);
+            double at = NAN;
+            for (size_t i = 0; i < samples.size() && samples[i].seconds <= detectedS; ++i) {
+                if (samples[i].seconds < previousS) {
+                    continue;
+                }
+                if (fabs(smoothedFeet(samples, i) - ground.mean) > ground.tolerance) {
+                    at = NAN;
+                } else if (std::isnan(at)) {
+                    at = samples[i].seconds;
+                }
+            }
+            return at;
+        }
+        default:
+            return NAN;
+    }
+}
+
+// Worst delay seen for each event, over every flight replayed
+static double worstDelayS[4] = {NAN, NAN, NAN, NAN};
+
+static void reportEvents(const std::vector<VsiSample>& samples, const std::vector<flightevents::Detection>& detections,
+                         uint16_t session, bool rocket) {
+    trace::RocketTimes truth = trace::rocketTimes(trace::RocketProfile());
+    double previousS = samples.empty() ? 0.0 : samples.front().seconds;
+    for (const flightevents::Detection& detection : detections) {
+        double detectedS = detection.detectedUs * 1e-6;
+        size_t index = static_cast<size_t>(detection.event);
+        double eventS = NAN;
+        if (rocket) {
+            eventS = detection.event == flightevents::Event::Launch   ? truth.launch
+                     : detection.event == flightevents::Event::Apogee ? truth.apogee
+                                                                      : truth.landing;
+        } else {
+            eventS = locateEvent(samples, detection.event, detectedS, previousS);
+        }
+        previousS = detectedS;
+
+        fprintf(stderr, "Events: session %u %-7s detected at %9.3f s, %7.1f ft", (unsigned)session,
+                EVENT_NAMES[index], detectedS, detection.altitudeFeet);
+        if (std::isnan(eventS)) {
+            fprintf(stderr, ", event not located\n");
+            continue;
+        }
+        double delay = detectedS - eventS;
+        fprintf(stderr, ", %.0f ms after the event\n", delay * 1000.0);
+        if (std::isnan(worstDelayS[index]) || delay > worstDelayS[index]) {
+            worstDelayS[index] = delay;
+        }
+    }
+}
+
+// Bytes a stream of samples takes in the flight log (page keyframes aside)
+struct StreamCost {
+    codec::Encoder encoder;
+    size_t records = 0;
+    size_t bytes = 0;
+
+    bool add(const logformat::Record& record) {
+        uint8_t buffer[codec::MAX_SAMPLE_BYTES];
+        bytes += encoder.encode(record, buffer, sizeof(buffer));
+        records++;
+        return true;
+    }
+};
+
+// Regular samples and flushed captures share the log as on the device
+static StreamCost g_logCost;
+static StreamCost g_fullRateCost;
+static capture::Capture g_capture;
+
+static bool appendCaptured(const logformat::Record& record) {
+    return g_logCost.add(record);
+}
+
+// The record the firmware logs for a pipeline output
+static logformat::Record toRecord(const pipeline::Output& output) {
+    logformat::Record record;
+    // Dated by the sensor's clock, so the time deltas the codec stores are
+    // its output period and mostly cancel; a failed read has only its own
+    // time
+    record.timeMs = output.valid ? static_cast<uint32_t>(output.sampleTimeUs / 1000) : output.timeMs;
+    record.pressureCentiPa = static_cast<int32_t>(lround(output.pressurePa * 100.0));
+    record.temperatureCentiC = static_cast<int16_t>(lround(output.temperatureC * 100.0));
+    record.flags = output.valid ? 0 : logformat::RECORD_SENSOR_ERROR;
+    return record;
+}
+
+static void reportCapture() {
+    while (g_capture.service(appendCaptured)) {
+    }
+    size_t regular = g_logCost.records - g_capture.getFlushedCount();
+    fprintf(stderr, "Capture: %u captures, %u samples captured, %u overruns\n", (unsigned)g_capture.getCaptureCount(),
+            (unsigned)g_capture.getFlushedCount(), (unsigned)g_capture.getOverrunCount());
+    fprintf(stderr, "Capture: log %zu bytes (%zu regular + %u captured samples), every sample %zu bytes (%zu samples)",
+            g_logCost.bytes, regular, (unsigned)g_capture.getFlushedCount(), g_fullRateCost.bytes,
+            g_fullRateCost.records);
+    if (g_fullRateCost.bytes > 0) {
+        fprintf(stderr, ": %.0f%%", 100.0 * g_logCost.bytes / g_fullRateCost.bytes);
+    }
+    fprintf(stderr, "\n");
+}
+
+static void reportVsi(std::vector<VsiSample>& samples, bool synthetic) {
+    if (samples.size() < 3) {
+        fprintf(stderr, "VSI: not enough samples\n");
+        return;
+    }
+    if (synthetic) {
+        trace::FlightProfile profile;
+        for (VsiSample& s : samples) {
+            s.referenceFpm = (trace::syntheticAltitudeFeet(profile, s.seconds + 0.05) -
+                              trace::syntheticAltitudeFeet(profile, s.seconds - 0.05)) / 0.1 * 60.0;
+        }
+    } else {
+        centredFit(samples, REFERENCE_HALF_WINDOW_S);
+    }
+
+    // Noise: spread of the estimate in level flight, once it has settled
+    double levelSum = 0;
+    size_t levelCount = 0;
+    double levelSince = NAN;
+    for (const VsiSample& s : samples) {
+        if (std::isnan(s.referenceFpm) || fabs(s.referenceFpm) >= LEVEL_FEET_PER_MINUTE) {
+            levelSince = NAN;
+            continue;
+        }
+        if (std::isnan(levelSince)) {
+            levelSince = s.seconds;
+        }
+        if (s.seconds - levelSince >= SETTLE_S) {
+            double error = s.feetPerMinute - s.referenceFpm;
+            levelSum += error * error;
+            levelCount++;
+        }
+    }
+
+    // Delay: the shift that best lines the estimate up with the reference
+    double bestDelay = 0;
+    double bestRms = INFINITY;
+    for (double delay = 0; delay <= MAX_DELAY_S; delay += DELAY_STEP_S) {
+        double sum = 0;
+        size_t count = 0;
+        for (const VsiSample& s : samples) {
+            double reference = referenceAt(samples, s.seconds - delay);
+            if (!std::isnan(reference)) {
+                double error = s.feetPerMinute - reference;
+                sum += error * error;
+                count++;
+            }
+        }
+        double rms = count ? sqrt(sum / count) : INFINITY;
+        if (rms < bestRms) {
+            bestRms = rms;
+            bestDelay = delay;
+        }
+    }
+
+    double period = (samples.back().seconds - samples.front().seconds) / (samples.size() - 1);
+    fprintf(stderr, "VSI: %zu samples every %.0f ms, against %s\n", samples.size(), period * 1000.0,
+            synthetic ? "the true profile" : "a centred fit");
+    if (levelCount) {
+        fprintf(stderr, "VSI: level flight noise %.1f ft/min RMS (%zu samples)\n", sqrt(levelSum / levelCount),
+                levelCount);
+    }
+    fprintf(stderr, "VSI: delay %.0f ms, residual %.1f ft/min RMS once aligned\n", bestDelay * 1000.0, bestRms);
+}
+
+int main(int argc, char** argv) {
+    bool csvInput = false;
+    bool synthetic = false;
+    bool rocket = false;
+    uint32_t seed = 1;
+    bool realTime = false;
+    uint32_t periodMs = config::DEFAULT_DISPLAY_PERIOD_MS;
+    uint32_t samplePeriodMs = VSI_SAMPLE_PERIOD_MS;
+    double defaultSeaLevelPa = 101325.0;
+    const char* outPath = nullptr;
+    const char* input = nullptr;
+    bool vsiReport = false;
+    bool eventsReport = false;
+    bool captureReport = false;
+    uint32_t preMs = capture::DEFAULT_PRE_MS;
+    uint32_t postMs = capture::DEFAULT_POST_MS;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--csv-in")) {
+            csvInput = true;
+        } else if (!strcmp(argv[i], "--synthetic")) {
+            synthetic = true;
+        } else if (!strcmp(argv[i], "--rocket")) {
+            rocket = true;
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = static_cast<uint32_t>(atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--realtime")) {
+            realTime = true;
+        } else if (!strcmp(argv[i], "--period") && i + 1 < argc) {
+            periodMs = static_cast<uint32_t>(atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--qnh") && i + 1 < argc) {
+            defaultSeaLevelPa = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (!strcmp(argv[i], "--sample-period") && i + 1 < argc) {
+            samplePeriodMs = static_cast<uint32_t>(atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--vsi-report")) {
+            vsiReport = true;
+        } else if (!strcmp(argv[i], "--events")) {
+            eventsReport = true;
+        } else if (!strcmp(argv[i], "--capture")) {
+            captureReport = true;
+        } else if (!strcmp(argv[i], "--pre") && i + 1 < argc) {
+            preMs = static_cast<uint32_t>(atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--post") && i + 1 < argc) {
+            postMs = static_cast<uint32_t>(atoi(argv[++i]));
+        } else if (argv[i][0] == '-' || input) {
+            usage();
+            return 1;
+        } else {
+            input = argv[i];
+        }
+    }
+    if ((synthetic && rocket) || (synthetic || rocket) == (input != nullptr) || periodMs == 0 ||
+        samplePeriodMs == 0) {
+        usage();
+        return 1;
+    }
+
+    g_capture.setWindows(preMs, postMs);
+
+    replay::Options options;
+    if (realTime) {
+        options.pacing = replay::Pacing::RealTime;
+        options.clock = millisSinceStart;
+    }
+
+    std::vector<logformat::Record> records;
+    logreader::MappedFile dump;
+    if (synthetic) {
+        trace::FlightProfile profile;
+        profile.seed = seed;
+        records = trace::syntheticFlight(profile);
+    } else if (rocket) {
+        trace::RocketProfile profile;
+        profile.seed = seed;
+        records = trace::syntheticRocket(profile);
+    } else if (csvInput) {
+        if (!trace::loadCsv(input, records)) {
+            fprintf(stderr, "Cannot read %s\n", input);
+            return 1;
+        }
+    } else if (!dump.open(input)) {
+        fprintf(stderr, "Cannot read %s\n", input);
+        return 1;
+    }
+    replay::ReplaySource source = (synthetic || rocket || csvInput)
+        ? replay::ReplaySource(records.data(), records.size(), options)
+        : replay::ReplaySource(dump.data(), dump.size(), options);
+
+    FILE* out = nullptr;
+    if (outPath) {
+        out = fopen(outPath, "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", outPath);
+            return 1;
+        }
+        fprintf(out, "session,time_ms,valid,pressure_pa,temperature_c,altitude_ft,display,vertical_fpm,event,outlier\n");
+    }
+
+    pipeline::Pipeline pipe;
+    pipe.setSeaLevelPressure(defaultSeaLevelPa);
+
+    size_t steps = 0;
+    double flightSeconds = 0.0;
+    uint32_t lastTimeMs = 0;
+    uint16_t lastSession = 0;
+    std::vector<VsiSample> vsiSamples;
+    bool vsiTaken = false;
+    uint32_t vsiLastMs = 0;
+    uint16_t vsiSession = 0;
+    std::vector<VsiSample> eventSamples;
+    std::vector<flightevents::Detection> detections;
+    uint16_t eventSession = 0;
+    bool logged = false;
+    uint32_t loggedMs = 0;
+    bool wasValid = true;
+    auto start = std::chrono::steady_clock::now();
+    auto nextTick = start;
+
+    while (!source.finished()) {
+        if (realTime) {
+            std::this_thread::sleep_until(nextTick);
+            nextTick += std::chrono::milliseconds(periodMs);
+        }
+        uint32_t before = source.getSampleCount();
+        bool valid = source.readSensor();
+        if (!realTime && source.getSampleCount() == before) {
+            break;
+        }
+
+        if (vsiReport && !vsiTaken) {
+            vsiSession = source.getSession();
+        }
+
+        // The report samples at the rate the firmware's timer feeds the
+        // estimator
+        if (vsiReport && vsiTaken && source.getSession() == lastSession && source.getTimeMs() >= vsiLastMs &&
+            source.getTimeMs() - vsiLastMs < samplePeriodMs) {
+            continue;
+        }
+
+        // Follow the altimeter setting recorded with the flight
+        if (source.getSeaLevelPressure() > 0) {
+            pipe.setSeaLevelPressure(source.getSeaLevelPressure());
+        }
+        pipeline::Output output =
+            pipe.process(source.getTimeMs(), valid, source.getPressure(), source.getTemperature(),
+                         source.getSampleTimeUs());
+        steps++;
+
+        if (steps > 1 && source.getSession() == lastSession && source.getTimeMs() >= lastTimeMs) {
+            flightSeconds += (source.getTimeMs() - lastTimeMs) / 1000.0;
+        }
+        lastTimeMs = source.getTimeMs();
+        lastSession = source.getSession();
+        // Only the first session: time starts again in the next one
+        if (vsiReport && output.valid && source.getSession() == vsiSession) {
+            vsiTaken = true;
+            vsiLastMs = source.getTimeMs();
+            vsiSamples.push_back({output.sampleTimeUs * 1e-6,
+                                  pipeline::altitudeFeet(output.pressurePa, 101325.0),
+                                  output.verticalFeetPerMinute, NAN});
+        }
+
+        // Events are reported a flight at a time, once it has all been seen
+        if (eventsReport && output.valid) {
+            if (source.getSession() != eventSession && !eventSamples.empty()) {
+                reportEvents(eventSamples, detections, eventSession, rocket);
+                eventSamples.clear();
+                detections.clear();
+            }
+            eventSession = source.getSession();
+            eventSamples.push_back({output.sampleTimeUs * 1e-6,
+                                    pipeline::altitudeFeet(output.pressurePa, 101325.0), 0.0, NAN});
+            if (output.flightEvent != flightevents::Event::None) {
+                detections.push_back(pipe.getLastDetection());
+            }
+        }
+
+        // Every sample into the capture ring, one a period into the log
+        if (captureReport) {
+            logformat::Record record = toRecord(output);
+            g_fullRateCost.add(record);
+            if (!logged || record.timeMs < loggedMs || record.timeMs - loggedMs >= periodMs) {
+                g_logCost.add(record);
+                logged = true;
+                loggedMs = record.timeMs;
+            }
+            g_capture.add(record);
+            if (capture::findTrigger(output, wasValid)) {
+                g_capture.trigger(record.timeMs);
+            }
+            wasValid = output.valid;
+            g_capture.service(appendCaptured);
+        }
+
+        if (out) {
+            fprintf(out, "%u,%u,%d,%.2f,%.2f,%.2f,%d,%.1f,%d,%d\n", (unsigned)source.getSession(),
+                    (unsigned)output.timeMs, output.valid ? 1 : 0, output.pressurePa, output.temperatureC,
+                    output.altitudeFeet, output.displayFeet, output.verticalFeetPerMinute,
+                    static_cast<int>(output.flightEvent), output.outlier ? 1 : 0);
+        }
+    }
+
+    if (out) {
+        fclose(out);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "Replayed %zu steps (%u samples, %.2f h of flight) in %.3f s", steps,
+            (unsigned)source.getSampleCount(), flightSeconds / 3600.0, seconds);
+    if (seconds > 0) {
+        fprintf(stderr, ": %.1f M steps/s, %.0fx real time", steps / seconds / 1e6, flightSeconds / seconds);
+    }
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Outliers: %u samples rejected (%.2f%%)\n", (unsigned)pipe.getOutlierCount(),
+            steps ? 100.0 * pipe.getOutlierCount() / steps : 0.0);
+
+    if (vsiReport) {
+        reportVsi(vsiSamples, synthetic);
+    }
+    if (captureReport) {
+        reportCapture();
+    }
+    if (eventsReport) {
+        if (!eventSamples.empty()) {
+            reportEvents(eventSamples, detections, eventSession, rocket);
+        }
+        for (size_t i = 1; i < 4; ++i) {
+            if (!std::isnan(worstDelayS[i])) {
+                fprintf(stderr, "Events: worst %s delay %.0f ms\n", EVENT_NAMES[i], worstDelayS[i] * 1000.0);
+            }
+        }
+    }
+    return 0;
+}
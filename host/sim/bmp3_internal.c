@@ -0,0 +1,26 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+//
+// The driver is compiled into this translation unit so its static helpers
+// can be wrapped. Host targets using this file must not also compile bmp3.c.
+
+#include "bmp3.c"
+#include "bmp3_internal.h"
+
+void bmp3_internal_parse_sensor_data(const uint8_t* reg_data, struct bmp3_uncomp_data* uncomp_data)
+{
+    parse_sensor_data(reg_data, uncomp_data);
+}
+
+int8_t bmp3_internal_compensate_data(uint8_t sensor_comp, const struct bmp3_uncomp_data* uncomp_data,
+                                     struct bmp3_data* comp_data, struct bmp3_calib_data* calib_data)
+{
+    return compensate_data(sensor_comp, uncomp_data, comp_data, calib_data);
+}
+
+void bmp3_internal_parse_calib_data(const uint8_t* reg_data, struct bmp3_calib_data* calib_data)
+{
+    struct bmp3_dev dev = { 0 };
+
+    parse_calib_data(reg_data, &dev);
+    *calib_data = dev.calib_data;
+}
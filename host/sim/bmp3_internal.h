@@ -0,0 +1,25 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+// Internal helpers of the Bosch BMP3 driver (static in bmp3.c), reachable
+// from host code for benchmarking and for the sensor simulation.
+
+#include "bmp3.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Split the 6 data register bytes into raw pressure and temperature
+void bmp3_internal_parse_sensor_data(const uint8_t* reg_data, struct bmp3_uncomp_data* uncomp_data);
+
+// Compensate raw readings (sensor_comp is BMP3_PRESS, BMP3_TEMP or both)
+int8_t bmp3_internal_compensate_data(uint8_t sensor_comp, const struct bmp3_uncomp_data* uncomp_data,
+                                     struct bmp3_data* comp_data, struct bmp3_calib_data* calib_data);
+
+// Decode the calibration register block (BMP3_LEN_CALIB_DATA bytes)
+void bmp3_internal_parse_calib_data(const uint8_t* reg_data, struct bmp3_calib_data* calib_data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,25 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+// Host stand-in for hardware/uart.h; output is discarded.
+
+#include "pico/stdlib.h"
+
+typedef struct uart_inst {
+    int index;
+} uart_inst_t;
+
+extern uart_inst_t uart0_inst;
+#define uart_default (&uart0_inst)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool uart_is_writable(uart_inst_t* uart);
+void uart_putc_raw(uart_inst_t* uart, char c);
+void uart_tx_wait_blocking(uart_inst_t* uart);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,32 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+// Host stand-in for the parts of the Pico SDK the drivers use. Time is
+// simulated: sleeps advance the clock instead of waiting (see sim.h).
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define PICO_OK 0
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+uint64_t to_us_since_boot(absolute_time_t t);
+uint64_t time_us_64(void);
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+void tight_loop_contents(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,28 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+// Host stand-in for pico/util/queue.h (single threaded, no locking).
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    uint8_t* data;
+    uint16_t wptr;
+    uint16_t rptr;
+    uint element_size;
+    uint element_count;
+} queue_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void queue_init(queue_t* q, uint element_size, uint element_count);
+bool queue_try_add(queue_t* q, const void* data);
+bool queue_try_remove(queue_t* q, void* data);
+void queue_remove_blocking(queue_t* q, void* data);
+bool queue_is_empty(queue_t* q);
+
+#ifdef __cplusplus
+}
+#endif
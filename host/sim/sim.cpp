@@ -0,0 +1,373 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "sim.h"
+#include "bmp3_internal.h"
+#include "sensorconfig.h"
+#include "hardware/i2c.h"
+#include "hardware/uart.h"
+#include "pico/stdlib.h"
+#include "pico/util/queue.h"
+#include <cstdlib>
+#include <cstring>
+
+i2c_inst_t i2c0_inst = {0};
+i2c_inst_t i2c1_inst = {1};
+uart_inst_t uart0_inst = {0};
+
+namespace sim {
+
+constexpr uint8_t BMP390_ADDRESS = 0x77;
+constexpr uint8_t HT16K33_ADDRESS = 0x70;
+
+// Calibration as read from a BMP390 (T1..T3, P1..P11, little-endian)
+static const uint8_t CALIBRATION[BMP3_LEN_CALIB_DATA] = {
+    0x6B, 0x6C,     // T1 27755
+    0x9B, 0x4A,     // T2 19099
+    0xF9,           // T3 -7
+    0xEB, 0x09,     // P1 2539
+    0x0D, 0xF1,     // P2 -3827
+    0x23,           // P3 35
+    0x01,           // P4 1
+    0x2F, 0x5F,     // P5 24367
+    0x74, 0x76,     // P6 30324
+    0x03,           // P7 3
+    0xFA,           // P8 -6
+    0x02, 0x3D,     // P9 15618
+    0x0A,           // P10 10
+    0xC4,           // P11 -60
+};
+
+static uint64_t nowUs = 0;
+static uint32_t transfers = 0;
+
+constexpr uint8_t SENSOR_TIME_REG = 0x0C;
+
+static uint8_t sensorRegisters[256];
+static uint8_t sensorPointer = 0;
+static bool sensorReady = false;
+
+static uint8_t displayRam[16];
+static uint8_t displayPointer = 0;
+
+// Conversion model (see setTruePressure())
+static bool converting = false;
+static double truePressurePa = 0.0;
+static double trueTemperatureC = 0.0;
+static double filteredPa = 0.0;
+static bool filterPrimed = false;
+static bool normalMode = false;
+static uint64_t normalModeUs = 0;      // When normal mode was entered
+static uint64_t conversions = 0;       // Since then
+static ConversionHook conversionHook = nullptr;
+
+static uint32_t i2cBaudHz = 0;
+
+uint64_t getTimeUs() {
+    return nowUs;
+}
+
+void advanceUs(uint64_t us) {
+    nowUs += us;
+}
+
+static void initSensor() {
+    if (sensorReady) {
+        return;
+    }
+    memset(sensorRegisters, 0, sizeof(sensorRegisters));
+    sensorRegisters[BMP3_REG_CHIP_ID] = BMP390_CHIP_ID;
+    sensorRegisters[BMP3_REG_SENS_STATUS] = BMP3_CMD_RDY | BMP3_DRDY_PRESS | BMP3_DRDY_TEMP;
+    memcpy(&sensorRegisters[BMP3_REG_CALIB_DATA], CALIBRATION, sizeof(CALIBRATION));
+    sensorReady = true;
+    setSensorSample(rawForSample(101325.0, 20.0));
+}
+
+static double compensate(uint32_t rawPressure, uint32_t rawTemperature, bool wantPressure,
+                         bmp3_calib_data& calib) {
+    bmp3_uncomp_data uncomp = {};
+    uncomp.pressure = rawPressure;
+    uncomp.temperature = rawTemperature;
+    bmp3_data data = {};
+    bmp3_internal_compensate_data(BMP3_PRESS_TEMP, &uncomp, &data, &calib);
+    return wantPressure ? data.pressure : data.temperature;
+}
+
+// Invert the (monotonic) compensation by bisection over the 24-bit range
+static uint32_t solve(double target, bool wantPressure, uint32_t rawOther, bmp3_calib_data& calib) {
+    uint32_t low = 0;
+    uint32_t high = 0xFFFFFF;
+    auto evaluate = [&](uint32_t raw) {
+        return wantPressure ? compensate(raw, rawOther, true, calib) : compensate(0, raw, false, calib);
+    };
+    bool rising = evaluate(high) > evaluate(low);
+    while (high - low > 1) {
+        uint32_t mid = low + (high - low) / 2;
+        if ((evaluate(mid) < target) == rising) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return high;
+}
+
+RawSample rawForSample(double pressurePa, double temperatureC) {
+    bmp3_calib_data calib;
+    bmp3_internal_parse_calib_data(CALIBRATION, &calib);
+    RawSample raw;
+    raw.temperature = solve(temperatureC, false, 0, calib);
+    raw.pressure = solve(pressurePa, true, raw.temperature, calib);
+    return raw;
+}
+
+// Finish the conversions due by now, oldest first
+static void convert() {
+    if (!converting || !normalMode) {
+        return;
+    }
+    uint8_t osr = sensorRegisters[BMP3_REG_OSR];
+    uint64_t measurementUs = sensorconfig::measurementTimeUs(osr & 0x07, (osr >> BMP3_TEMP_OS_POS) & 0x07);
+    uint64_t periodUs = sensorconfig::odrPeriodUs(sensorRegisters[BMP3_REG_ODR] & 0x1F);
+    uint32_t coefficient = (1u << ((sensorRegisters[BMP3_REG_CONFIG] >> BMP3_IIR_FILTER_POS) & 0x07)) - 1;
+    while (normalModeUs + conversions * periodUs + measurementUs <= nowUs) {
+        uint64_t timeUs = normalModeUs + conversions * periodUs + measurementUs;
+        conversions++;
+        filteredPa = filterPrimed ? (filteredPa * coefficient + truePressurePa) / (coefficient + 1) : truePressurePa;
+        filterPrimed = true;
+        setSensorSample(rawForSample(filteredPa, trueTemperatureC));
+        sensorRegisters[BMP3_REG_SENS_STATUS] |= BMP3_DRDY_PRESS | BMP3_DRDY_TEMP;
+        if (conversionHook) {
+            conversionHook(timeUs, filteredPa);
+        }
+    }
+}
+
+void setTruePressure(double pressurePa, double temperatureC) {
+    initSensor();
+    convert();
+    converting = true;
+    truePressurePa = pressurePa;
+    trueTemperatureC = temperatureC;
+}
+
+void setConversionHook(ConversionHook hook) {
+    conversionHook = hook;
+}
+
+void setI2cBaud(uint32_t baudHz) {
+    i2cBaudHz = baudHz;
+}
+
+uint64_t transferUs(size_t bytes) {
+    return i2cBaudHz ? (bytes + 1) * 9 * 1000000ull / i2cBaudHz : 0;
+}
+
+void setSensorSample(const RawSample& raw) {
+    initSensor();
+    uint8_t* data = &sensorRegisters[BMP3_REG_DATA];
+    data[0] = raw.pressure & 0xFF;
+    data[1] = (raw.pressure >> 8) & 0xFF;
+    data[2] = (raw.pressure >> 16) & 0xFF;
+    data[3] = raw.temperature & 0xFF;
+    data[4] = (raw.temperature >> 8) & 0xFF;
+    data[5] = (raw.temperature >> 16) & 0xFF;
+}
+
+const uint8_t* getCalibrationRegisters() {
+    return CALIBRATION;
+}
+
+const uint8_t* getDisplayRam() {
+    return displayRam;
+}
+
+uint32_t getI2cTransfers() {
+    return transfers;
+}
+
+// Sensor writes: a register pointer, then (as the BMP3 driver sends them)
+// data followed by (register, data) pairs
+static void sensorWrite(const uint8_t* src, size_t len) {
+    initSensor();
+    sensorPointer = src[0];
+    if (len >= 2) {
+        uint8_t status = sensorRegisters[BMP3_REG_SENS_STATUS];
+        uint8_t reg = src[0];
+        sensorRegisters[reg] = src[1];
+        bool power = reg == BMP3_REG_PWR_CTRL;
+        for (size_t i = 2; i + 1 < len; i += 2) {
+            reg = src[i];
+            sensorRegisters[reg] = src[i + 1];
+            power |= reg == BMP3_REG_PWR_CTRL;
+        }
+        // The soft reset command and the status bits are not stored
+        uint8_t ready = BMP3_DRDY_PRESS | BMP3_DRDY_TEMP;
+        ready = converting ? (status & ready) : ready;
+        sensorRegisters[BMP3_REG_CMD] = 0;
+        sensorRegisters[BMP3_REG_SENS_STATUS] = BMP3_CMD_RDY | ready;
+        sensorRegisters[BMP3_REG_ERR] = 0;
+
+        // Entering normal mode starts the conversion schedule (and the
+        // filter) afresh
+        if (converting && power) {
+            normalMode = ((sensorRegisters[BMP3_REG_PWR_CTRL] >> BMP3_OP_MODE_POS) & 0x03) == BMP3_MODE_NORMAL;
+            normalModeUs = nowUs;
+            conversions = 0;
+            filterPrimed = false;
+            sensorRegisters[BMP3_REG_SENS_STATUS] = BMP3_CMD_RDY;
+        }
+    }
+}
+
+static void sensorRead(uint8_t* dst, size_t len) {
+    initSensor();
+    convert();
+    // Sensor time runs at 25.6 kHz (39.0625 us per tick)
+    uint32_t sensorTime = static_cast<uint32_t>(nowUs * 256 / 10000) & 0xFFFFFF;
+    sensorRegisters[SENSOR_TIME_REG] = sensorTime & 0xFF;
+    sensorRegisters[SENSOR_TIME_REG + 1] = (sensorTime >> 8) & 0xFF;
+    sensorRegisters[SENSOR_TIME_REG + 2] = (sensorTime >> 16) & 0xFF;
+    for (size_t i = 0; i < len; ++i) {
+        dst[i] = sensorRegisters[static_cast<uint8_t>(sensorPointer + i)];
+    }
+    // Reading the pressure data clears the data ready flags
+    if (converting && sensorPointer <= BMP3_REG_DATA && sensorPointer + len > BMP3_REG_DATA) {
+        sensorRegisters[BMP3_REG_SENS_STATUS] &= static_cast<uint8_t>(~(BMP3_DRDY_PRESS | BMP3_DRDY_TEMP));
+    }
+    sensorPointer = static_cast<uint8_t>(sensorPointer + len);
+}
+
+// Display writes: a command byte, or a RAM address followed by data
+static void displayWrite(const uint8_t* src, size_t len) {
+    if (len > 1 && src[0] < sizeof(displayRam)) {
+        displayPointer = src[0];
+        for (size_t i = 1; i < len; ++i) {
+            displayRam[(displayPointer + i - 1) % sizeof(displayRam)] = src[i];
+        }
+    }
+}
+
+}  // namespace sim
+
+extern "C" {
+
+absolute_time_t get_absolute_time(void) {
+    return sim::nowUs;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return static_cast<uint32_t>(t / 1000);
+}
+
+uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+uint64_t time_us_64(void) {
+    return sim::nowUs;
+}
+
+void sleep_ms(uint32_t ms) {
+    sim::nowUs += static_cast<uint64_t>(ms) * 1000;
+}
+
+void sleep_us(uint64_t us) {
+    sim::nowUs += us;
+}
+
+void tight_loop_contents(void) {
+}
+
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop) {
+    (void)nostop;
+    sim::transfers++;
+    sim::nowUs += sim::transferUs(len);
+    if (len == 0) {
+        return PICO_ERROR_GENERIC;
+    }
+    if (i2c == i2c0 && addr == sim::BMP390_ADDRESS) {
+        sim::sensorWrite(src, len);
+    } else if (i2c == i2c1 && addr == sim::HT16K33_ADDRESS) {
+        sim::displayWrite(src, len);
+    } else {
+        return PICO_ERROR_GENERIC;
+    }
+    return static_cast<int>(len);
+}
+
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop) {
+    (void)nostop;
+    sim::transfers++;
+    sim::nowUs += sim::transferUs(len);
+    if (i2c == i2c0 && addr == sim::BMP390_ADDRESS) {
+        sim::sensorRead(dst, len);
+        return static_cast<int>(len);
+    }
+    return PICO_ERROR_GENERIC;
+}
+
+int i2c_write_timeout_us(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop,
+                         uint timeout_us) {
+    (void)timeout_us;
+    return i2c_write_blocking(i2c, addr, src, len, nostop);
+}
+
+int i2c_read_timeout_us(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint timeout_us) {
+    (void)timeout_us;
+    return i2c_read_blocking(i2c, addr, dst, len, nostop);
+}
+
+bool uart_is_writable(uart_inst_t* uart) {
+    (void)uart;
+    return true;
+}
+
+void uart_putc_raw(uart_inst_t* uart, char c) {
+    (void)uart;
+    (void)c;
+}
+
+void uart_tx_wait_blocking(uart_inst_t* uart) {
+    (void)uart;
+}
+
+void queue_init(queue_t* q, uint element_size, uint element_count) {
+    // One spare slot tells full from empty, as in the SDK
+    q->data = static_cast<uint8_t*>(calloc(element_count + 1, element_size));
+    q->element_size = element_size;
+    q->element_count = element_count;
+    q->wptr = 0;
+    q->rptr = 0;
+}
+
+bool queue_try_add(queue_t* q, const void* data) {
+    uint16_t next = static_cast<uint16_t>((q->wptr + 1) % (q->element_count + 1));
+    if (next == q->rptr) {
+        return false;
+    }
+    memcpy(q->data + q->wptr * q->element_size, data, q->element_size);
+    q->wptr = next;
+    return true;
+}
+
+bool queue_try_remove(queue_t* q, void* data) {
+    if (q->rptr == q->wptr) {
+        return false;
+    }
+    memcpy(data, q->data + q->rptr * q->element_size, q->element_size);
+    q->rptr = static_cast<uint16_t>((q->rptr + 1) % (q->element_count + 1));
+    return true;
+}
+
+void queue_remove_blocking(queue_t* q, void* data) {
+    // Nothing can arrive while blocked in a single-threaded simulation
+    if (!queue_try_remove(q, data)) {
+        abort();
+    }
+}
+
+bool queue_is_empty(queue_t* q) {
+    return q->rptr == q->wptr;
+}
+
+}  // extern "C"
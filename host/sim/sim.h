@@ -0,0 +1,60 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Simulated hardware behind the host SDK shims: a clock that sleeps advance,
+// a BMP390 on i2c0 at 0x77 and an HT16K33 on i2c1 at 0x70. Lets the real
+// drivers run unmodified in host benchmarks.
+namespace sim {
+
+// Simulated time since boot
+uint64_t getTimeUs();
+void advanceUs(uint64_t us);
+
+// Raw 24-bit sensor ADC values
+struct RawSample {
+    uint32_t pressure;
+    uint32_t temperature;
+};
+
+// Raw values that the simulated sensor's calibration compensates to the
+// given pressure (Pa) and temperature (C)
+RawSample rawForSample(double pressurePa, double temperatureC);
+
+// Set the data registers returned by subsequent sensor reads
+void setSensorSample(const RawSample& raw);
+
+// Conversions. Once a true pressure is set the sensor converts on its own
+// schedule, as the real part does in normal mode: from when normal mode was
+// entered, every output data period (ODR register) it finishes a conversion
+// after the oversampling's measurement time, runs it through the IIR filter
+// (CONFIG register) and latches the result into the data registers with the
+// data ready flags set; reading the data clears them. Set it before starting
+// the sensor. Until then reads return setSensorSample()'s values and always
+// show data ready.
+void setTruePressure(double pressurePa, double temperatureC);
+
+// Called at each conversion with its time and the filtered pressure latched
+using ConversionHook = void (*)(uint64_t timeUs, double pressurePa);
+void setConversionHook(ConversionHook hook);
+
+// I2C bus time: transfers take as long as they would at baudHz (9 clocks a
+// byte, the address included), advancing the clock. 0, the default, makes
+// them instant.
+void setI2cBaud(uint32_t baudHz);
+
+// Time a transfer of bytes (plus the address) takes on the bus
+uint64_t transferUs(size_t bytes);
+
+// The simulated sensor's calibration registers (BMP3_LEN_CALIB_DATA bytes)
+const uint8_t* getCalibrationRegisters();
+
+// Display RAM last written to the HT16K33 (16 bytes)
+const uint8_t* getDisplayRam();
+
+// I2C transfers made so far, on both buses
+uint32_t getI2cTransfers();
+
+}  // namespace sim
@@ -0,0 +1,182 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "trace.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace trace {
+
+constexpr double FEET_PER_METER = 3.28084;
+constexpr double GRAVITY_FEET_PER_S2 = 32.174;
+
+// Inverse of the barometric formula: pressure at a height above the ground
+static double pressureAtFeet(double groundPressurePa, double feet) {
+    double meters = feet / FEET_PER_METER;
+    return groundPressurePa * pow(1.0 - meters / 44330.0, 1.0 / 0.1903);
+}
+
+bool loadCsv(const char* path, std::vector<logformat::Record>& out) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        double timeMs, pressure, temperature;
+        unsigned flags = 0;
+        int fields = sscanf(line, "%lf,%lf,%lf,%u", &timeMs, &pressure, &temperature, &flags);
+        if (fields < 3) {
+            continue;
+        }
+        logformat::Record record;
+        record.timeMs = static_cast<uint32_t>(timeMs);
+        record.pressureCentiPa = static_cast<int32_t>(lround(pressure * 100.0));
+        record.temperatureCentiC = static_cast<int16_t>(lround(temperature * 100.0));
+        record.flags = static_cast<uint16_t>(flags);
+        out.push_back(record);
+    }
+
+    fclose(file);
+    return true;
+}
+
+bool saveCsv(const char* path, const std::vector<logformat::Record>& records) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "# time_ms,pressure_pa,temperature_c,flags\n");
+    for (const logformat::Record& record : records) {
+        fprintf(file, "%u,%.2f,%.2f,%u\n", (unsigned)record.timeMs, record.pressureCentiPa / 100.0,
+                record.temperatureCentiC / 100.0, (unsigned)record.flags);
+    }
+    return fclose(file) == 0;
+}
+
+double syntheticAltitudeFeet(const FlightProfile& profile, double t) {
+    double climbSeconds = profile.cruiseFeet / profile.climbFeetPerMinute * 60.0;
+    double descentSeconds = profile.cruiseFeet / profile.descentFeetPerMinute * 60.0;
+
+    if (t < profile.groundSeconds) {
+        return 0.0;
+    }
+    t -= profile.groundSeconds;
+    if (t < climbSeconds) {
+        return t * profile.climbFeetPerMinute / 60.0;
+    }
+    t -= climbSeconds;
+    if (t < profile.cruiseSeconds) {
+        return profile.cruiseFeet;
+    }
+    t -= profile.cruiseSeconds;
+    if (t < descentSeconds) {
+        return profile.cruiseFeet - t * profile.descentFeetPerMinute / 60.0;
+    }
+    return 0.0;
+}
+
+std::vector<logformat::Record> syntheticFlight(const FlightProfile& profile) {
+    double climbSeconds = profile.cruiseFeet / profile.climbFeetPerMinute * 60.0;
+    double descentSeconds = profile.cruiseFeet / profile.descentFeetPerMinute * 60.0;
+    double totalSeconds = 2 * profile.groundSeconds + climbSeconds + profile.cruiseSeconds + descentSeconds;
+
+    std::mt19937 rng(profile.seed);
+    std::normal_distribution<double> pressureNoise(0.0, profile.pressureNoisePa);
+    std::normal_distribution<double> temperatureNoise(0.0, 0.005);
+    std::uniform_int_distribution<int> jitter(0, 19);
+
+    std::vector<logformat::Record> records;
+    records.reserve(static_cast<size_t>(totalSeconds * 1000.0 / profile.periodMs) + 1);
+
+    uint32_t timeMs = 0;
+    while (timeMs / 1000.0 < totalSeconds) {
+        double feet = syntheticAltitudeFeet(profile, timeMs / 1000.0);
+        double meters = feet / FEET_PER_METER;
+        double pressure = pressureAtFeet(profile.groundPressurePa, feet);
+        double temperature = 20.0 - 0.0065 * meters;
+
+        logformat::Record record;
+        record.timeMs = timeMs;
+        record.pressureCentiPa = static_cast<int32_t>(lround((pressure + pressureNoise(rng)) * 100.0));
+        record.temperatureCentiC = static_cast<int16_t>(lround((temperature + temperatureNoise(rng)) * 100.0));
+        record.flags = 0;
+        records.push_back(record);
+
+        // The event loop occasionally runs a tick late
+        timeMs += profile.periodMs + (jitter(rng) == 0 ? 1 : 0);
+    }
+    return records;
+}
+
+RocketTimes rocketTimes(const RocketProfile& profile) {
+    double burnoutSpeed = profile.boostFeetPerS2 * profile.boostSeconds;
+    double burnoutFeet = 0.5 * burnoutSpeed * profile.boostSeconds;
+    double apogeeFeet = burnoutFeet + burnoutSpeed * burnoutSpeed / (2.0 * GRAVITY_FEET_PER_S2);
+
+    // Free fall until the parachute's descent rate, then steady
+    double fallSeconds = profile.descentFeetPerSecond / GRAVITY_FEET_PER_S2;
+    double fallFeet = 0.5 * profile.descentFeetPerSecond * fallSeconds;
+
+    RocketTimes times;
+    times.launch = profile.padSeconds;
+    times.apogee = times.launch + profile.boostSeconds + burnoutSpeed / GRAVITY_FEET_PER_S2;
+    times.landing = times.apogee + fallSeconds + (apogeeFeet - fallFeet) / profile.descentFeetPerSecond;
+    return times;
+}
+
+double rocketAltitudeFeet(const RocketProfile& profile, double t) {
+    RocketTimes times = rocketTimes(profile);
+    double burnoutSpeed = profile.boostFeetPerS2 * profile.boostSeconds;
+    double burnoutFeet = 0.5 * burnoutSpeed * profile.boostSeconds;
+    double apogeeFeet = burnoutFeet + burnoutSpeed * burnoutSpeed / (2.0 * GRAVITY_FEET_PER_S2);
+    double fallSeconds = profile.descentFeetPerSecond / GRAVITY_FEET_PER_S2;
+
+    if (t < times.launch || t >= times.landing) {
+        return 0.0;
+    }
+    t -= times.launch;
+    if (t < profile.boostSeconds) {
+        return 0.5 * profile.boostFeetPerS2 * t * t;
+    }
+    t -= profile.boostSeconds;
+    double coastSeconds = times.apogee - times.launch - profile.boostSeconds;
+    if (t < coastSeconds) {
+        return burnoutFeet + burnoutSpeed * t - 0.5 * GRAVITY_FEET_PER_S2 * t * t;
+    }
+    t -= coastSeconds;
+    if (t < fallSeconds) {
+        return apogeeFeet - 0.5 * GRAVITY_FEET_PER_S2 * t * t;
+    }
+    t -= fallSeconds;
+    return apogeeFeet - 0.5 * profile.descentFeetPerSecond * fallSeconds - profile.descentFeetPerSecond * t;
+}
+
+std::vector<logformat::Record> syntheticRocket(const RocketProfile& profile) {
+    double totalSeconds = rocketTimes(profile).landing + profile.landedSeconds;
+
+    std::mt19937 rng(profile.seed);
+    std::normal_distribution<double> pressureNoise(0.0, profile.pressureNoisePa);
+
+    std::vector<logformat::Record> records;
+    records.reserve(static_cast<size_t>(totalSeconds * 1000.0 / profile.periodMs) + 1);
+    for (uint32_t timeMs = 0; timeMs / 1000.0 < totalSeconds; timeMs += profile.periodMs) {
+        double feet = rocketAltitudeFeet(profile, timeMs / 1000.0);
+        double pressure = pressureAtFeet(profile.groundPressurePa, feet);
+
+        logformat::Record record;
+        record.timeMs = timeMs;
+        record.pressureCentiPa = static_cast<int32_t>(lround((pressure + pressureNoise(rng)) * 100.0));
+        record.temperatureCentiC = 2000;
+        record.flags = 0;
+        records.push_back(record);
+    }
+    return records;
+}
+
+}  // namespace trace
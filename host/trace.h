@@ -0,0 +1,66 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "logformat.h"
+
+// Sample traces for host tools: recorded CSV files or a synthetic flight.
+namespace trace {
+
+// Load a CSV trace with lines "time_ms,pressure_pa,temperature_c[,flags]"
+// Blank lines, lines starting with '#' and a non-numeric header are skipped
+bool loadCsv(const char* path, std::vector<logformat::Record>& out);
+
+// Write records in the same CSV format
+bool saveCsv(const char* path, const std::vector<logformat::Record>& records);
+
+// Synthetic flight: ground, climb, cruise, descent and ground again, with
+// sensor noise and loop jitter, sampled every periodMs
+struct FlightProfile {
+    uint32_t periodMs = 20;
+    double groundSeconds = 60.0;
+    double climbFeetPerMinute = 1000.0;
+    double cruiseFeet = 3000.0;
+    double cruiseSeconds = 300.0;
+    double descentFeetPerMinute = 700.0;
+    double groundPressurePa = 101325.0;
+    double pressureNoisePa = 1.2;
+    uint32_t seed = 1;
+};
+
+std::vector<logformat::Record> syntheticFlight(const FlightProfile& profile = FlightProfile());
+
+// Altitude above ground of the synthetic flight at time t (feet), for
+// comparing estimators against the truth
+double syntheticAltitudeFeet(const FlightProfile& profile, double seconds);
+
+// Synthetic rocket flight: pad, powered boost, coast to apogee without
+// drag, descent under a parachute opening at apogee, and the pad again,
+// sampled every periodMs (the HighRate sensor profile's 50 Hz)
+struct RocketProfile {
+    uint32_t periodMs = 20;
+    double padSeconds = 30.0;
+    double boostSeconds = 1.5;
+    double boostFeetPerS2 = 200.0;          // Net of gravity
+    double descentFeetPerSecond = 20.0;
+    double landedSeconds = 30.0;
+    double groundPressurePa = 101325.0;
+    double pressureNoisePa = 1.2;
+    uint32_t seed = 1;
+};
+
+std::vector<logformat::Record> syntheticRocket(const RocketProfile& profile = RocketProfile());
+
+// Height of the synthetic rocket above the pad at time t (feet)
+double rocketAltitudeFeet(const RocketProfile& profile, double seconds);
+
+// When the synthetic rocket launches, reaches apogee and lands (seconds)
+struct RocketTimes {
+    double launch;
+    double apogee;
+    double landing;
+};
+RocketTimes rocketTimes(const RocketProfile& profile);
+
+}  // namespace trace
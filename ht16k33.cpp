@@ -67,8 +67,47 @@ constexpr uint8_t SEG_E = 0x10;  // Bottom-left
 constexpr uint8_t SEG_F = 0x20;  // Top-left
 constexpr uint8_t SEG_G = 0x40;  // Middle
 
+// Power-on test: all segments, then the outline, then the chase below
+constexpr uint32_t TEST_OUTLINE_STEP = 1;
+
+// Chase sequence (clockwise from top-left):
+// 1. Digit 0, segment A (top-left, top)
+// 2. Digit 1, segment A
+// 3. Digit 2, segment A
+// 4. Digit 3, segment A (top-right, top)
+// 5. Digit 3, segment B (top-right corner)
+// 6. Digit 3, segment C (bottom-right corner)
+// 7. Digit 3, segment D (bottom-right, bottom)
+// 8. Digit 2, segment D
+// 9. Digit 1, segment D
+// 10. Digit 0, segment D (bottom-left, bottom)
+// 11. Digit 0, segment E (bottom-left corner)
+// 12. Digit 0, segment F (top-left corner) - back to start
+struct ChaseStep {
+    uint8_t position;
+    uint8_t segment;
+};
+
+constexpr ChaseStep CHASE_SEQUENCE[] = {
+    {0, SEG_A},  // Top of digit 0
+    {1, SEG_A},  // Top of digit 1
+    {2, SEG_A},  // Top of digit 2
+    {3, SEG_A},  // Top of digit 3
+    {3, SEG_B},  // Top-right of digit 3
+    {3, SEG_C},  // Bottom-right of digit 3
+    {3, SEG_D},  // Bottom of digit 3
+    {2, SEG_D},  // Bottom of digit 2
+    {1, SEG_D},  // Bottom of digit 1
+    {0, SEG_D},  // Bottom of digit 0
+    {0, SEG_E},  // Bottom-left of digit 0
+    {0, SEG_F},  // Top-left of digit 0
+};
+
+constexpr size_t CHASE_LENGTH = sizeof(CHASE_SEQUENCE) / sizeof(CHASE_SEQUENCE[0]);
+
 HT16K33::HT16K33(i2c_inst_t* i2c_instance) : i2cAddress(HT16K33_I2C_ADDRESS), i2c(i2c_instance) {
-    memset(displayBuffer, 0, sizeof(displayBuffer));
+    frame.address = 0x00;
+    memset(frame.ram, 0, sizeof(frame.ram));
 }
 
 void HT16K33::begin() {
@@ -154,20 +193,17 @@ void HT16K33::displayDigit(uint8_t position, uint8_t digit, bool dot) {
     } else {
         address = (position * 2) + 2;  // Skip the colon at 0x04
     }
-    displayBuffer[address] = pattern;
+    frame.ram[address] = pattern;
 }
 
 void HT16K33::writeDisplay() {
-    // The HT16K33 expects the display RAM address (0x00) followed by 16 bytes
-    uint8_t buffer[17];
-    buffer[0] = 0x00; // Start at address 0x00
-    memcpy(buffer + 1, displayBuffer, sizeof(displayBuffer));
-    
-    i2c_write_blocking(i2c, i2cAddress, buffer, sizeof(buffer), false);
+    // The HT16K33 expects the display RAM address (0x00) followed by 16 bytes,
+    // which is how the frame is laid out
+    i2c_write_blocking(i2c, i2cAddress, getFrame(), FRAME_BYTES, false);
 }
 
 void HT16K33::clear() {
-    memset(displayBuffer, 0, sizeof(displayBuffer));
+    memset(frame.ram, 0, sizeof(frame.ram));
     writeDisplay();
 }
 
@@ -175,22 +211,21 @@ void HT16K33::setColon(bool on) {
     // The colon is at address 0x04 in the display buffer
     // On the Adafruit 7-segment backpack, bit 1 (0x02) controls the colon
     if (on) {
-        displayBuffer[4] = 0x02;
+        frame.ram[4] = 0x02;
     } else {
-        displayBuffer[4] = 0x00;
+        frame.ram[4] = 0x00;
     }
 }
 
 void HT16K33::testDisplay() {
-    // Light up all segments on all digits including colon
-    for (uint8_t i = 0; i < 4; ++i) {
-        displayDigit(i, 8, true); // 8 lights up all segments, true adds decimal point
+    runTest(0);
+}
+
+void HT16K33::runTest(uint32_t firstStep) {
+    uint32_t holdMs;
+    for (uint32_t step = firstStep; (holdMs = testStep(step)) > 0; ++step) {
+        sleep_ms(holdMs);
     }
-    setColon(true);  // Turn on the colon
-    writeDisplay();
-    sleep_ms(1000); // Keep it lit for 1 second
-    clear();
-    displayOutlineChase();
 }
 
 void HT16K33::setSegment(uint8_t position, uint8_t segmentMask) {
@@ -207,69 +242,51 @@ void HT16K33::setSegment(uint8_t position, uint8_t segmentMask) {
         address = (position * 2) + 2;
     }
     
-    displayBuffer[address] = segmentMask;
+    frame.ram[address] = segmentMask;
 }
 
 void HT16K33::displayOutlineChase() {
-    // Part 1: Light up the outer rectangle of the display for 1 second
+    runTest(TEST_OUTLINE_STEP);
+}
+
+uint32_t HT16K33::testStep(uint32_t step) {
+    // Step 0: every segment, decimal point and the colon
+    if (step == 0) {
+        for (uint8_t i = 0; i < 4; ++i) {
+            displayDigit(i, 8, true); // 8 lights up all segments, true adds decimal point
+        }
+        setColon(true);
+        writeDisplay();
+        return 1000;
+    }
+
+    // Step 1: the outer rectangle of the display
     // Digit 0 (leftmost): A, F, E, D (top, left side, bottom)
     // Digit 1: A, D (top, bottom)
     // Digit 2: A, D (top, bottom)
     // Digit 3 (rightmost): A, B, C, D (top, right side, bottom)
-    
-    clear();
-    setSegment(0, SEG_A | SEG_F | SEG_E | SEG_D);  // Left digit: top, left edges, bottom
-    setSegment(1, SEG_A | SEG_D);                   // Second digit: top, bottom
-    setSegment(2, SEG_A | SEG_D);                   // Third digit: top, bottom
-    setSegment(3, SEG_A | SEG_B | SEG_C | SEG_D);  // Right digit: top, right edges, bottom
-    writeDisplay();
-    sleep_ms(1000);
-    
-    // Part 2: LED chase clockwise from top-left, one LED at a time
-    // Chase sequence (clockwise from top-left):
-    // 1. Digit 0, segment A (top-left, top)
-    // 2. Digit 1, segment A
-    // 3. Digit 2, segment A
-    // 4. Digit 3, segment A (top-right, top)
-    // 5. Digit 3, segment B (top-right corner)
-    // 6. Digit 3, segment C (bottom-right corner)
-    // 7. Digit 3, segment D (bottom-right, bottom)
-    // 8. Digit 2, segment D
-    // 9. Digit 1, segment D
-    // 10. Digit 0, segment D (bottom-left, bottom)
-    // 11. Digit 0, segment E (bottom-left corner)
-    // 12. Digit 0, segment F (top-left corner) - back to start
-    
-    struct ChaseStep {
-        uint8_t position;
-        uint8_t segment;
-    };
-    
-    constexpr ChaseStep chaseSequence[] = {
-        {0, SEG_A},  // Top of digit 0
-        {1, SEG_A},  // Top of digit 1
-        {2, SEG_A},  // Top of digit 2
-        {3, SEG_A},  // Top of digit 3
-        {3, SEG_B},  // Top-right of digit 3
-        {3, SEG_C},  // Bottom-right of digit 3
-        {3, SEG_D},  // Bottom of digit 3
-        {2, SEG_D},  // Bottom of digit 2
-        {1, SEG_D},  // Bottom of digit 1
-        {0, SEG_D},  // Bottom of digit 0
-        {0, SEG_E},  // Bottom-left of digit 0
-        {0, SEG_F},  // Top-left of digit 0
-    };
-    
-    constexpr size_t chaseLength = sizeof(chaseSequence) / sizeof(chaseSequence[0]);
-    
-    for (size_t i = 0; i < chaseLength; ++i) {
-        clear();
-        setSegment(chaseSequence[i].position, chaseSequence[i].segment);
+    if (step == TEST_OUTLINE_STEP) {
+        memset(frame.ram, 0, sizeof(frame.ram));
+        setSegment(0, SEG_A | SEG_F | SEG_E | SEG_D);  // Left digit: top, left edges, bottom
+        setSegment(1, SEG_A | SEG_D);                   // Second digit: top, bottom
+        setSegment(2, SEG_A | SEG_D);                   // Third digit: top, bottom
+        setSegment(3, SEG_A | SEG_B | SEG_C | SEG_D);  // Right digit: top, right edges, bottom
         writeDisplay();
-        sleep_ms(250);  // Quarter second per step
+        return 1000;
     }
-    
+
+    // Then an LED chase clockwise from top-left, one LED at a time, a
+    // quarter second per step
+    uint32_t chase = step - (TEST_OUTLINE_STEP + 1);
+    if (chase < CHASE_LENGTH) {
+        memset(frame.ram, 0, sizeof(frame.ram));
+        setSegment(CHASE_SEQUENCE[chase].position, CHASE_SEQUENCE[chase].segment);
+        writeDisplay();
+        return 250;
+    }
+
     clear();
+    return 0;
 }
 
 void HT16K33::displayNumber(int number, int decimalPos) {
@@ -294,8 +311,30 @@ void HT16K33::displayNumber(int number, int decimalPos) {
     displayDigit(1, hundreds, decimalPos == 1);
     displayDigit(2, tens, decimalPos == 2);
     displayDigit(3, ones, decimalPos == 3);
-    writeDisplay();
 }
 
+void HT16K33::displaySignedNumber(int number, int decimalPos) {
+    bool negative = number < 0;
+    int magnitude = negative ? -number : number;
+    int limit = negative ? 999 : 9999;  // The sign takes a digit
+    if (magnitude > limit) {
+        magnitude = limit;
+    }
+
+    // Digits from the right, then the sign, then blanks
+    int position = 3;
+    do {
+        displayDigit(position, magnitude % 10, decimalPos == position);
+        magnitude /= 10;
+        position--;
+    } while (magnitude > 0);
+    if (negative) {
+        setSegment(position, SEG_G);
+        position--;
+    }
+    for (; position >= 0; position--) {
+        setSegment(position, 0);
+    }
+}
 
-}  // namespace ht16k33
\ No newline at end of file
+}  // namespace ht16k33
@@ -2,30 +2,56 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 typedef struct i2c_inst i2c_inst_t;
 
 namespace ht16k33 {
 
+// A frame on the bus: the display RAM address (0), then the 16 RAM bytes
+constexpr size_t RAM_BYTES = 16;
+constexpr size_t FRAME_BYTES = RAM_BYTES + 1;
+
 class HT16K33 {
 public:
     HT16K33(i2c_inst_t* i2c);
     void begin();
     void setBrightness(uint8_t brightness);
     void setBlinkRate(uint8_t rate);
+    // These update the display buffer; writeDisplay() sends it in one
+    // transfer, so a whole frame (digits and colon) changes at once
     void displayDigit(uint8_t position, uint8_t digit, bool dot = false);
     void displayNumber(int number, int decimalPos = -1);
+    // Right aligned without leading zeros, negative values with a minus sign
+    // (-999 to 9999, clamped)
+    void displaySignedNumber(int number, int decimalPos = -1);
     void setColon(bool on);
     void writeDisplay();
     void clear();
 
+    // The frame writeDisplay() sends, for handing to a background write
+    const uint8_t* getFrame() const { return &frame.address; }
+    uint8_t getAddress() const { return i2cAddress; }
+
+    // Power-on test pattern, blocking for about five seconds
     void testDisplay();
     void displayOutlineChase();
 
+    // Show step n of the test pattern without waiting. Returns how long to
+    // hold it in milliseconds, or 0 (display cleared) after the last step.
+    // Lets the test run from a task while the loop keeps going.
+    uint32_t testStep(uint32_t step);
+
 private:
+    void runTest(uint32_t firstStep);
     void setSegment(uint8_t position, uint8_t segmentMask);
-    uint8_t displayBuffer[16];
+    struct Frame {
+        uint8_t address;        // Display RAM address, always 0
+        uint8_t ram[RAM_BYTES];
+    };
+    static_assert(sizeof(Frame) == FRAME_BYTES, "Frame must be sent as laid out");
+    Frame frame;
     uint8_t i2cAddress;
     i2c_inst_t* i2c;
 };
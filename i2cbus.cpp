@@ -0,0 +1,248 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "i2cbus.h"
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+namespace i2cbus {
+
+static_assert(BUSES == NUM_I2CS, "One entry per I2C controller");
+
+struct Bus {
+    int channel = -1;                   // DMA channel feeding the controller, or -1
+    volatile bool writing = false;      // Background write in flight
+    volatile bool writeOk = true;
+    bool claimed = false;               // Blocking transfer in progress
+    uint64_t writeStartUs = 0;
+    task::Completion* done = nullptr;
+
+    // Controller commands: a data byte each, STOP on the last
+    uint16_t commands[MAX_WRITE];
+};
+static Bus buses[BUSES];
+
+// Accounting since the last change of either bus's state
+static uint64_t lastChangeUs = 0;
+static uint64_t frameStartUs = 0;
+static uint64_t frameBusyUs[BUSES] = {};
+static uint64_t frameOverlapUs = 0;
+static Stats stats = {};
+
+static bool isBusy(const Bus& bus) {
+    return bus.writing || bus.claimed;
+}
+
+// Charge the time since the last change to whichever buses were busy.
+// Interrupts must be off (or this is the controller interrupt).
+static void account(uint64_t nowUs) {
+    uint64_t elapsed = nowUs - lastChangeUs;
+    lastChangeUs = nowUs;
+    bool both = true;
+    for (size_t i = 0; i < BUSES; ++i) {
+        if (isBusy(buses[i])) {
+            frameBusyUs[i] += elapsed;
+        } else {
+            both = false;
+        }
+    }
+    if (both) {
+        frameOverlapUs += elapsed;
+    }
+}
+
+static void finishWrite(Bus& bus, bool ok) {
+    account(time_us_64());
+    bus.writing = false;
+    bus.writeOk = ok;
+    if (bus.done) {
+        bus.done->signal();
+        bus.done = nullptr;
+    }
+}
+
+// STOP detected: the write is over. An abort (NACK) stops the DMA; the
+// controller then sends the STOP itself.
+static void handleInterrupt(uint index) {
+    Bus& bus = buses[index];
+    i2c_hw_t* hw = i2c_get_hw(i2c_get_instance(index));
+    uint32_t status = hw->intr_stat;
+    if (!bus.writing) {
+        // Blocking transfers poll the raw status; keep out of their way
+        hw->intr_mask = 0;
+        return;
+    }
+    if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        dma_channel_abort(bus.channel);
+        (void)hw->clr_tx_abrt;
+        bus.writeOk = false;
+    }
+    if (status & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        hw->intr_mask = 0;
+        finishWrite(bus, bus.writeOk);
+    }
+}
+
+static void i2c0Interrupt() {
+    handleInterrupt(0);
+}
+
+static void i2c1Interrupt() {
+    handleInterrupt(1);
+}
+
+// Give up on a write whose STOP never came
+static void abandon(uint index) {
+    Bus& bus = buses[index];
+    uint32_t saved = save_and_disable_interrupts();
+    if (bus.writing) {
+        dma_channel_abort(bus.channel);
+        i2c_get_hw(i2c_get_instance(index))->intr_mask = 0;
+        finishWrite(bus, false);
+        stats.abandoned++;
+    }
+    restore_interrupts(saved);
+}
+
+static void waitIdle(uint index) {
+    Bus& bus = buses[index];
+    while (bus.writing) {
+        if (time_us_64() - bus.writeStartUs > WRITE_TIMEOUT_US) {
+            abandon(index);
+        }
+        tight_loop_contents();
+    }
+}
+
+bool init() {
+    static const irq_handler_t HANDLERS[BUSES] = {i2c0Interrupt, i2c1Interrupt};
+    static const uint IRQS[BUSES] = {I2C0_IRQ, I2C1_IRQ};
+    bool ok = true;
+    for (uint i = 0; i < BUSES; ++i) {
+        i2c_inst_t* i2c = i2c_get_instance(i);
+        i2c_hw_t* hw = i2c_get_hw(i2c);
+        int channel = dma_claim_unused_channel(false);
+        if (channel < 0) {
+            ok = false;
+            continue;
+        }
+        dma_channel_config config = dma_channel_get_default_config(channel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_write_increment(&config, false);
+        channel_config_set_dreq(&config, i2c_get_dreq(i2c, true));
+        dma_channel_configure(channel, &config, &hw->data_cmd, buses[i].commands, 0, false);
+        buses[i].channel = channel;
+
+        hw->intr_mask = 0;
+        irq_set_exclusive_handler(IRQS[i], HANDLERS[i]);
+        irq_set_enabled(IRQS[i], true);
+    }
+    lastChangeUs = frameStartUs = time_us_64();
+    return ok;
+}
+
+bool startWrite(i2c_inst_t* i2c, uint8_t address, const uint8_t* data, size_t length, task::Completion& done) {
+    uint index = i2c_get_index(i2c);
+    Bus& bus = buses[index];
+    if (bus.channel < 0 || length == 0 || length > MAX_WRITE) {
+        return false;
+    }
+    waitIdle(index);
+
+    for (size_t i = 0; i < length; ++i) {
+        bus.commands[i] = data[i] | (i + 1 == length ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+    }
+
+    // Address the device as the SDK does, with the controller briefly off.
+    // DMA requests are re-enabled in case a bus recovery reset the controller.
+    i2c_hw_t* hw = i2c_get_hw(i2c);
+    hw->enable = 0;
+    hw->tar = address;
+    hw->enable = 1;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+    (void)hw->clr_stop_det;
+    (void)hw->clr_tx_abrt;
+
+    done.reset();
+    uint32_t saved = save_and_disable_interrupts();
+    account(time_us_64());
+    bus.done = &done;
+    bus.writeOk = true;
+    bus.writing = true;
+    bus.writeStartUs = lastChangeUs;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    restore_interrupts(saved);
+
+    dma_channel_transfer_from_buffer_now(bus.channel, bus.commands, length);
+    return true;
+}
+
+bool lastWriteOk(i2c_inst_t* i2c) {
+    return buses[i2c_get_index(i2c)].writeOk;
+}
+
+bool service() {
+    bool any = false;
+    for (uint i = 0; i < BUSES; ++i) {
+        if (buses[i].writing && time_us_64() - buses[i].writeStartUs > WRITE_TIMEOUT_US) {
+            abandon(i);
+            any = true;
+        }
+    }
+    return any;
+}
+
+Claim::Claim(i2c_inst_t* i2c) : index(static_cast<uint8_t>(i2c_get_index(i2c))) {
+    waitIdle(index);
+    uint32_t saved = save_and_disable_interrupts();
+    account(time_us_64());
+    buses[index].claimed = true;
+    restore_interrupts(saved);
+}
+
+Claim::~Claim() {
+    uint32_t saved = save_and_disable_interrupts();
+    account(time_us_64());
+    buses[index].claimed = false;
+    restore_interrupts(saved);
+}
+
+void endFrame() {
+    uint32_t saved = save_and_disable_interrupts();
+    uint64_t nowUs = time_us_64();
+    account(nowUs);
+    uint64_t frameUs = nowUs - frameStartUs;
+    if (frameUs > 0) {
+        for (size_t i = 0; i < BUSES; ++i) {
+            float utilisation = static_cast<float>(frameBusyUs[i]) / frameUs;
+            stats.peakUtilisation[i] = utilisation > stats.peakUtilisation[i] ? utilisation : stats.peakUtilisation[i];
+            stats.busyUs[i] += frameBusyUs[i];
+            frameBusyUs[i] = 0;
+        }
+        stats.overlapUs += frameOverlapUs;
+        stats.elapsedUs += frameUs;
+        stats.frames++;
+    }
+    frameOverlapUs = 0;
+    frameStartUs = nowUs;
+    restore_interrupts(saved);
+}
+
+Stats getStats() {
+    uint32_t saved = save_and_disable_interrupts();
+    Stats copy = stats;
+    restore_interrupts(saved);
+    return copy;
+}
+
+void resetStats() {
+    uint32_t saved = save_and_disable_interrupts();
+    stats = Stats{};
+    restore_interrupts(saved);
+}
+
+}  // namespace i2cbus
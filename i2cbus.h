@@ -0,0 +1,75 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "task.h"
+
+typedef struct i2c_inst i2c_inst_t;
+
+// Transactions on the two I2C controllers. Each controller carries one
+// transaction at a time and the two run at once. A write can be handed to
+// DMA and finish in the background, its Completion signalled by the
+// controller's STOP interrupt, so the display's frame goes out on one bus
+// while the CPU carries on, reading a sensor on the other if it has one to
+// read. Blocking transfers (the sensor driver's) claim their bus for as long
+// as they run, after any background write on it has finished. The time each
+// bus is busy, and the time both are, is accounted frame by frame.
+namespace i2cbus {
+
+constexpr size_t BUSES = 2;
+
+// Longest background write, in bytes
+constexpr size_t MAX_WRITE = 32;
+
+// A background write still running after this is abandoned (32 bytes take
+// about 3 ms at 100 kHz)
+constexpr uint32_t WRITE_TIMEOUT_US = 10000;
+
+// Claim a DMA channel and the interrupt of each controller. Call after the
+// controllers are initialised. Returns false if DMA is unavailable; writes
+// are then left to the caller to make blocking.
+bool init();
+
+// Start writing data to address on i2c in the background, waiting for a
+// previous background write on that bus first. data is copied. done is
+// reset now and signalled when the STOP has gone out or the transfer was
+// abandoned. Returns false if nothing was started.
+bool startWrite(i2c_inst_t* i2c, uint8_t address, const uint8_t* data, size_t length, task::Completion& done);
+
+// Whether the last background write on i2c went out acknowledged
+bool lastWriteOk(i2c_inst_t* i2c);
+
+// Abandon background writes that have run past WRITE_TIMEOUT_US, so no task
+// waits on them forever. Call from the idle loop. Returns true if one was.
+bool service();
+
+// Holds a bus for a blocking transfer while in scope
+class Claim {
+public:
+    explicit Claim(i2c_inst_t* i2c);
+    ~Claim();
+    Claim(const Claim&) = delete;
+    Claim& operator=(const Claim&) = delete;
+
+private:
+    uint8_t index;
+};
+
+// Close the accounting for the current frame and start the next. Call once
+// a frame (display period).
+void endFrame();
+
+struct Stats {
+    uint32_t frames;
+    uint64_t elapsedUs;
+    uint64_t busyUs[BUSES];
+    uint64_t overlapUs;                 // Both buses busy
+    float peakUtilisation[BUSES];       // Busiest single frame, share of its time
+    uint32_t abandoned;                 // Background writes that timed out
+};
+
+Stats getStats();
+void resetStats();
+
+}  // namespace i2cbus
@@ -0,0 +1,78 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "logformat.h"
+#include "crc32.h"
+#include "samplecodec.h"
+#include <cstring>
+
+namespace logformat {
+
+static uint32_t pageCrc(const uint8_t* page, size_t payloadLength) {
+    PageHeader header;
+    memcpy(&header, page, sizeof(header));
+    header.crc = 0;
+    uint32_t crc = crc::crc32(&header, sizeof(header));
+    return crc::crc32(page + sizeof(PageHeader), payloadLength, crc);
+}
+
+void sealPage(uint8_t* page) {
+    PageHeader* header = reinterpret_cast<PageHeader*>(page);
+    if (header->format == PAGE_FORMAT_RAW) {
+        header->payloadLength = static_cast<uint16_t>(header->count * sizeof(Record));
+    }
+    header->crc = pageCrc(page, header->payloadLength);
+}
+
+bool isValidPage(const uint8_t* page) {
+    PageHeader header;
+    memcpy(&header, page, sizeof(header));
+    if (header.magic != PAGE_MAGIC || header.payloadLength > PAGE_PAYLOAD_SIZE) {
+        return false;
+    }
+    return header.crc == pageCrc(page, header.payloadLength);
+}
+
+bool isErasedPage(const uint8_t* page) {
+    const uint32_t* words = reinterpret_cast<const uint32_t*>(page);
+    for (size_t i = 0; i < PAGE_SIZE / sizeof(uint32_t); ++i) {
+        if (words[i] != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t readRecords(const uint8_t* page, Record* out, size_t maxRecords) {
+    const PageHeader* header = getHeader(page);
+    if (header->format == PAGE_FORMAT_DELTA) {
+        const uint8_t* payload = page + sizeof(PageHeader);
+        size_t remaining = header->payloadLength;
+        size_t count = 0;
+        codec::Decoder decoder;
+        while (count < header->count && count < maxRecords && remaining > 0) {
+            size_t used = decoder.decode(payload, remaining, out[count]);
+            if (used == 0) {
+                break;
+            }
+            payload += used;
+            remaining -= used;
+            count++;
+        }
+        return count;
+    }
+    if (header->format != PAGE_FORMAT_RAW) {
+        return 0;
+    }
+
+    size_t count = header->count;
+    if (count > RECORDS_PER_PAGE) {
+        count = RECORDS_PER_PAGE;
+    }
+    if (count > maxRecords) {
+        count = maxRecords;
+    }
+    memcpy(out, page + sizeof(PageHeader), count * sizeof(Record));
+    return count;
+}
+
+}  // namespace logformat
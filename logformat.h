@@ -0,0 +1,68 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "flashmap.h"
+
+// On-flash format of the flight log. Shared by the firmware writer and host
+// tools, so it only depends on the standard library.
+namespace logformat {
+
+// One altitude sample
+struct Record {
+    uint32_t timeMs;             // Milliseconds since boot when the sample was converted
+                                 // (sensor clock), or read if the read failed
+    int32_t pressureCentiPa;     // Pressure in Pa * 100
+    int16_t temperatureCentiC;   // Temperature in C * 100
+    uint16_t flags;              // RECORD_* bits
+};
+static_assert(sizeof(Record) == 12, "Record must stay packed");
+
+// Record flags
+constexpr uint16_t RECORD_SENSOR_ERROR = 0x0001;   // Read failed, values repeat the last good sample
+constexpr uint16_t RECORD_CAPTURE = 0x0002;        // Full-rate sample from around an event, flushed late
+                                                   // and out of time order with the regular samples
+
+// Every page is self-describing so a reader never needs anything but the page
+// itself. The CRC covers the header (with crc = 0) and the payload; a page
+// torn by a power cut fails the check and is skipped.
+struct PageHeader {
+    uint32_t magic;              // PAGE_MAGIC
+    uint32_t sequence;           // Increases by one per page across the whole log
+    uint16_t session;            // Increases by one per boot
+    uint8_t format;              // PAGE_FORMAT_*
+    uint8_t count;               // Records in the payload
+    uint16_t payloadLength;      // Bytes of payload used
+    uint16_t reserved;
+    uint32_t seaLevelCentiPa;    // Altimeter setting in effect for the page
+    uint32_t crc;
+};
+static_assert(sizeof(PageHeader) == 24, "PageHeader must stay packed");
+
+constexpr uint32_t PAGE_MAGIC = 0x474F4C41;   // "ALOG"
+constexpr uint8_t PAGE_FORMAT_RAW = 1;        // Payload is an array of Record
+constexpr uint8_t PAGE_FORMAT_DELTA = 2;      // Payload is a codec stream starting with a keyframe
+
+constexpr size_t PAGE_SIZE = flashmap::PAGE_SIZE;
+constexpr size_t PAGE_PAYLOAD_SIZE = PAGE_SIZE - sizeof(PageHeader);
+constexpr size_t RECORDS_PER_PAGE = PAGE_PAYLOAD_SIZE / sizeof(Record);
+
+// Fill in the crc of a page whose other header fields and payload are
+// already in place (payloadLength is derived from count for raw pages)
+void sealPage(uint8_t* page);
+
+// True if the page has the magic, a sane length and a matching CRC
+bool isValidPage(const uint8_t* page);
+
+// True if every byte of the page reads as erased flash
+bool isErasedPage(const uint8_t* page);
+
+inline const PageHeader* getHeader(const uint8_t* page) {
+    return reinterpret_cast<const PageHeader*>(page);
+}
+
+// Decode the records of a valid page into out, returns the number decoded
+size_t readRecords(const uint8_t* page, Record* out, size_t maxRecords);
+
+}  // namespace logformat
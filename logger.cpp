@@ -0,0 +1,268 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "logger.h"
+#include <pico/stdlib.h>
+#include <hardware/uart.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+namespace logger {
+
+// Format strings, indexed by Msg
+static const char* const FORMATS[] = {
+    "BMP390::begin() - Initializing at address 0x%02X\n",
+    "BMP390: bmp3_init failed with error %d\n",
+    "  Chip ID read: 0x%02X (expected 0x50 for BMP388 or 0x60 for BMP390)\n",
+    "BMP390: Chip ID = 0x%02X\n",
+    "BMP390: writing settings failed with error %d\n",
+    "BMP390: settings not accepted, error %d\n",
+    "BMP390: Initialized successfully!\n",
+    "BMP390: bmp3_get_sensor_data failed with error %d\n",
+    "Sensor read failed!\n",
+    "Encoder: delta=%d, position=%d, state=%d\n",
+    "Button pressed: switching to SETTING mode\n",
+    "Button pressed: switching to ALTIMETER mode\n",
+    "Updated sea level pressure to %.2f Pa (%.2f inHg)\n",
+    "Probing for BMP390 sensors on i2c0 and i2c1...\n",
+    "No BMP390 sensor started, retrying in the background\n",
+    "%u BMP390 sensor(s) in use\n",
+    "Encoder initialized to %d (%.2f inHg)\n",
+    "Timer started\n",
+    "Entering event loop in ALTIMETER mode...\n",
+    "Press button to switch to VSI, then SETTING mode\n",
+    "Received unknown event type %d in main loop\n",
+    "Flash operation at 0x%06X failed with error %d\n",
+    "Flight log: program image ends at 0x%06X, overlaps log, logging disabled\n",
+    "Flight log: session %u, head at 0x%06X, next page %u\n",
+    "Config: loaded slot %d, sequence %u\n",
+    "Config: no valid copy in flash, using defaults\n",
+    "Config: saved to slot %u, sequence %u\n",
+    "Config: save to slot %u failed\n",
+    "Replay: playing the flight log instead of the sensor\n",
+    "Replay: flight log is empty\n",
+    "Sensor i2c%u 0x%02X fault: %s, recovering\n",
+    "Sensor i2c%u 0x%02X recovery attempt %u failed, retrying in %u ms\n",
+    "Sensor i2c%u 0x%02X recovered after %u attempts\n",
+    "I2C bus clear: SDA %s\n",
+    "Restarted by the watchdog\n",
+    "Found BMP390 on i2c%u at 0x%02X\n",
+    "Task: no frame for a %u byte coroutine (pool of %u x %u bytes)\n",
+    "Display: %u frames for input (%u requests coalesced), input to display mean %u us, max %u us\n",
+    "Button pressed: switching to VSI mode\n",
+    "Flight: launch detected at %.1f ft, %u ms\n",
+    "Flight: apogee %.1f ft at %u ms, detected %u ms later\n",
+    "Flight: landed at %.1f ft at %u ms, detected %u ms later\n",
+    "Capture: %s at %u ms\n",
+    "Capture: flushed, %u samples so far, %u overruns\n",
+    "Pressure: %.1f hPa, %+.1f hPa in 3 h, trend %+.2f hPa/h\n",
+    "Outlier: %.1f Pa rejected (%u so far)\n",
+    "I2C: %u frames, i2c0 busy %.1f%%, i2c1 busy %.1f%%, both %.1f%%\n",
+    "I2C: busiest frame i2c0 %.1f%%, i2c1 %.1f%%, %u writes abandoned\n",
+    "Sampling: locked to the sensor's %u us conversions, data %u us old when read\n",
+    "Sampling: lost the sensor's conversion phase (%u stale reads so far)\n",
+};
+static_assert(sizeof(FORMATS) / sizeof(FORMATS[0]) == static_cast<size_t>(Msg::Count),
+              "FORMATS must have one entry per logger::Msg");
+
+// Ring configuration (must be a power of two)
+constexpr uint32_t RING_SIZE = 32;
+static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+
+// Bounded multi-producer ring. Each slot carries a sequence number: a slot is
+// free for position p when seq == p and holds a message when seq == p + 1.
+// Producers claim a position with a CAS, so an ISR that preempts a producer
+// simply takes the next slot instead of waiting for it.
+struct Slot {
+    std::atomic<uint32_t> seq;
+    Msg id;
+    uint8_t count;
+    Arg args[MAX_ARGS];
+};
+
+static Slot ring[RING_SIZE];
+static std::atomic<uint32_t> writePos{0};
+static uint32_t readPos = 0;             // Only touched by the draining loop
+static std::atomic<uint32_t> overflowCount{0};
+static uint32_t reportedOverflows = 0;
+
+// Formatted line waiting for UART space
+static char line[128];
+static size_t lineLength = 0;
+static size_t lineSent = 0;
+static bool carriageReturnSent = false;
+
+void initLogger() {
+    for (uint32_t i = 0; i < RING_SIZE; ++i) {
+        ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+    writePos.store(0, std::memory_order_relaxed);
+    readPos = 0;
+    lineLength = 0;
+    lineSent = 0;
+}
+
+bool post(Msg id, const Arg* args, uint8_t count) {
+    uint32_t pos = writePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &ring[pos & (RING_SIZE - 1)];
+        uint32_t seq = slot->seq.load(std::memory_order_acquire);
+        int32_t diff = static_cast<int32_t>(seq - pos);
+        if (diff == 0) {
+            if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Ring is full - count it rather than wait
+            overflowCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = writePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->id = id;
+    slot->count = count > MAX_ARGS ? MAX_ARGS : count;
+    for (uint8_t i = 0; i < slot->count; ++i) {
+        slot->args[i] = args[i];
+    }
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// Expand one message into the line buffer. Conversions are handled one at a
+// time so each argument can be passed to snprintf with its proper type.
+static size_t format(char* out, size_t size, const char* fmt, const Arg* args, uint8_t count) {
+    size_t length = 0;
+    uint8_t argIndex = 0;
+
+    while (*fmt && length + 1 < size) {
+        if (*fmt != '%') {
+            out[length++] = *fmt++;
+            continue;
+        }
+
+        // Collect the conversion spec, e.g. "%.2f" or "%02X"
+        char spec[16];
+        size_t specLength = 0;
+        spec[specLength++] = *fmt++;
+        while (*fmt && !strchr("diuxXcfeEgGs%", *fmt) && specLength < sizeof(spec) - 2) {
+            spec[specLength++] = *fmt++;
+        }
+        char conversion = *fmt;
+        if (conversion) {
+            spec[specLength++] = *fmt++;
+        }
+        spec[specLength] = '\0';
+
+        int written;
+        if (conversion == '%') {
+            written = snprintf(out + length, size - length, "%%");
+        } else if (argIndex >= count) {
+            written = snprintf(out + length, size - length, "?");
+        } else {
+            const Arg& arg = args[argIndex++];
+            switch (conversion) {
+                case 'd': case 'i': case 'c':
+                    written = snprintf(out + length, size - length, spec, static_cast<int>(arg.i));
+                    break;
+                case 'u': case 'x': case 'X':
+                    written = snprintf(out + length, size - length, spec, static_cast<unsigned>(arg.u));
+                    break;
+                case 'f': case 'e': case 'E': case 'g': case 'G':
+                    written = snprintf(out + length, size - length, spec, static_cast<double>(arg.f));
+                    break;
+                case 's':
+                    written = snprintf(out + length, size - length, spec, arg.s ? arg.s : "(null)");
+                    break;
+                default:
+                    written = 0;
+                    break;
+            }
+        }
+
+        if (written < 0) {
+            break;
+        }
+        length += static_cast<size_t>(written);
+        if (length >= size) {
+            length = size - 1;
+        }
+    }
+
+    out[length] = '\0';
+    return length;
+}
+
+// Load the next message into the line buffer, returns false if there is none
+static bool loadNextLine() {
+    uint32_t dropped = overflowCount.load(std::memory_order_relaxed);
+    if (dropped != reportedOverflows) {
+        Arg arg;
+        arg.u = dropped - reportedOverflows;
+        reportedOverflows = dropped;
+        lineLength = format(line, sizeof(line), "Log overflow: %u messages dropped\n", &arg, 1);
+        lineSent = 0;
+        return true;
+    }
+
+    Slot& slot = ring[readPos & (RING_SIZE - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != readPos + 1) {
+        return false;
+    }
+
+    size_t index = static_cast<size_t>(slot.id);
+    const char* fmt = index < static_cast<size_t>(Msg::Count) ? FORMATS[index] : "Unknown log message\n";
+    lineLength = format(line, sizeof(line), fmt, slot.args, slot.count);
+    lineSent = 0;
+
+    // Release the slot for the next lap of the ring
+    slot.seq.store(readPos + RING_SIZE, std::memory_order_release);
+    readPos++;
+    return true;
+}
+
+// Push the current line into the UART FIFO, returns true if it went out completely
+static bool transmit(bool blocking) {
+    while (lineSent < lineLength) {
+        if (!blocking && !uart_is_writable(uart_default)) {
+            return false;
+        }
+        // Expand \n to \r\n like stdio_uart does
+        char c = line[lineSent];
+        if (c == '\n' && !carriageReturnSent) {
+            uart_putc_raw(uart_default, '\r');
+            carriageReturnSent = true;
+            continue;
+        }
+        uart_putc_raw(uart_default, c);
+        carriageReturnSent = false;
+        lineSent++;
+    }
+    return true;
+}
+
+bool service() {
+    while (true) {
+        if (!transmit(false)) {
+            return true;
+        }
+        if (!loadNextLine()) {
+            return false;
+        }
+    }
+}
+
+void flush() {
+    do {
+        transmit(true);
+    } while (loadNextLine());
+    uart_tx_wait_blocking(uart_default);
+}
+
+uint32_t getOverflowCount() {
+    return overflowCount.load(std::memory_order_relaxed);
+}
+
+}  // namespace logger
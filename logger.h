@@ -0,0 +1,122 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace logger {
+
+// Message identifiers. Each ID maps to a printf-style format string in
+// logger.cpp; call sites only store the ID and its raw arguments, the text is
+// formatted and transmitted later when the event loop is idle.
+enum class Msg : uint16_t {
+    SensorBegin,            // address
+    SensorInitFailed,       // error
+    SensorChipIdRead,       // chip id
+    SensorChipId,           // chip id
+    SensorSettingsFailed,   // error
+    SensorOpModeFailed,     // error
+    SensorInitialized,
+    SensorReadError,        // error
+    SensorReadFailed,
+    EncoderChange,          // delta, position, state
+    ModeSetting,
+    ModeAltimeter,
+    SeaLevelUpdated,        // pascals, inHg
+    SensorProbe,
+    SensorInitAborted,
+    SensorReady,            // sensor count
+    EncoderInitialized,     // position, inHg
+    TimerStarted,
+    LoopStarted,
+    LoopHint,
+    UnknownEvent,           // event type
+    FlashError,             // offset, error
+    FlightLogImageOverlap,  // image end
+    FlightLogResumed,       // session, head offset, sequence
+    ConfigLoaded,           // slot, sequence
+    ConfigDefaults,
+    ConfigSaved,            // slot, sequence
+    ConfigSaveFailed,       // slot
+    ReplayStarted,
+    ReplayEmpty,
+    SensorFault,            // bus, address, reason
+    SensorRetry,            // bus, address, attempt, next retry ms
+    SensorRecovered,        // bus, address, attempts
+    I2cBusCleared,          // SDA released
+    WatchdogReboot,
+    SensorFound,            // bus, address
+    TaskNoFrame,            // frame size, pool frames, frame size limit
+    RenderLatency,          // frames, coalesced requests, mean us, max us
+    ModeVsi,
+    FlightLaunch,           // height ft, detected at ms
+    FlightApogee,           // height ft, at ms, detected ms later
+    FlightLanding,          // height ft, at ms, detected ms later
+    CaptureStarted,         // trigger, at ms
+    CaptureFlushed,         // samples flushed in total, overruns in total
+    PressureHistory,        // mean hPa, 3 h tendency hPa, 24 h trend hPa/h
+    SampleOutlier,          // pressure Pa, rejected so far
+    I2cUtilisation,         // frames, i2c0 %, i2c1 %, both at once %
+    I2cPeak,                // i2c0 peak %, i2c1 peak %, abandoned writes
+    PhaseLocked,            // period us, data age us
+    PhaseLost,              // stale reads so far
+    Count
+};
+
+// One stored argument. Integers are kept as 32 bits, floating point values
+// are narrowed to float and strings must have static storage duration.
+union Arg {
+    int32_t i;
+    uint32_t u;
+    float f;
+    const char* s;
+};
+
+constexpr uint8_t MAX_ARGS = 4;
+
+// Initialize the log ring
+void initLogger();
+
+// Store a message in the ring (IRQ-safe, safe from either core, never blocks)
+// Returns false and counts an overflow if the ring is full
+bool post(Msg id, const Arg* args, uint8_t count);
+
+// Format and transmit pending messages without blocking on the UART
+// Returns true while there is still output waiting to go out
+bool service();
+
+// Drain everything, blocking on the UART (use before halting)
+void flush();
+
+// Number of messages dropped because the ring was full
+uint32_t getOverflowCount();
+
+template <typename T>
+inline Arg makeArg(T value) {
+    Arg arg;
+    if constexpr (std::is_floating_point_v<T>) {
+        arg.f = static_cast<float>(value);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        arg.i = static_cast<int32_t>(value);
+    } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+        arg.u = static_cast<uint32_t>(value);
+    } else {
+        static_assert(std::is_convertible_v<T, const char*>, "unsupported log argument type");
+        arg.s = value;
+    }
+    return arg;
+}
+
+// Deferred replacement for printf: logger::log(Msg::SensorInitFailed, rslt)
+template <typename... Args>
+inline bool log(Msg id, Args... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+    if constexpr (sizeof...(Args) == 0) {
+        return post(id, nullptr, 0);
+    } else {
+        const Arg packed[] = {makeArg(args)...};
+        return post(id, packed, sizeof...(Args));
+    }
+}
+
+}  // namespace logger
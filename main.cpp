@@ -7,138 +7,607 @@
 #include "event.h"
 #include "timer.h"
 #include "encoder.h"
+#include "logger.h"
+#include "mode.h"
+#include "flightlog.h"
+#include "capture.h"
+#include "history.h"
+#include "i2cbus.h"
+#include "config.h"
+#include "phaselock.h"
+#include "pipeline.h"
+#include "probe.h"
+#include "render.h"
+#include "sensorarray.h"
+#include "supervisor.h"
+#include "task.h"
+#include <cmath>
 
-// State machine states
-enum class DeviceState {
-    Altimeter,  // Display altitude
-    Setting     // Display/adjust sea level pressure
-};
+#if PICO_ALTIMETER_REPLAY
+#include "flashmap.h"
+#include "flashwrite.h"
+#include "replay.h"
+#endif
 
 // Conversion constant: 1 inHg = 3386.389 Pa
 constexpr double INHG_TO_PA = 3386.389;
 
-// Default sea level pressure: 29.92 inHg = 2992 in encoder units
-constexpr int32_t DEFAULT_PRESSURE_INHG_X100 = 2992;
-
-// Global display and sensor pointers for event handlers
+// Global display and sample source pointers for event handlers
 static ht16k33::HT16K33* g_display = nullptr;
-static bmp390::BMP390* g_sensor = nullptr;
-static DeviceState g_state = DeviceState::Altimeter;
+static sampling::Source* g_source = nullptr;
+static pipeline::Pipeline g_pipeline;
+static mode::Mode g_mode = mode::Mode::Altimeter;
+static uint32_t g_configuredPeriodMs = 250;
+static uint32_t g_sensorPeriodMs = 80;         // Sensor output data period
+static uint32_t g_samplesPerPeriod = 1;        // Samples per configured period in this mode
+static uint32_t g_sampleCount = 0;             // Samples since entering the mode
+static bool g_selfTestRunning = false;
+static bool g_flightLogReady = false;
+static capture::Capture g_capture;
+static history::History g_history;
+#if !PICO_ALTIMETER_REPLAY
+static sensorarray::SensorArray* g_sensors = nullptr;
+static bool g_phaseLocked = false;             // Reads locked to the lead sensor's conversions
+#endif
 
-// Update the setting display (used by both timer and encoder events)
-void updateDisplay() {
-    if (!g_sensor || !g_display) return;
+// Flight log record for a pipeline sample
+static logformat::Record toRecord(const pipeline::Output& output) {
+    logformat::Record record;
+    // Dated by the sensor's clock, so the time deltas the codec stores are
+    // its output period and mostly cancel; a failed read has only its own
+    // time
+    record.timeMs = output.valid ? static_cast<uint32_t>(output.sampleTimeUs / 1000) : output.timeMs;
+    record.pressureCentiPa = static_cast<int32_t>(lround(output.pressurePa * 100.0));
+    record.temperatureCentiC = static_cast<int16_t>(lround(output.temperatureC * 100.0));
+    record.flags = output.valid ? 0 : logformat::RECORD_SENSOR_ERROR;
+    return record;
+}
 
-    switch(g_state) {
-        case DeviceState::Altimeter: {    
-            if (!g_sensor->readSensor()) {
-                printf("Sensor read failed!\n");
-                return;
-            }
-            int altitudeFeet = g_sensor->getAltitudeFeet();
-            g_display->displayNumber(altitudeFeet);
-            g_display->setColon(false);
-            g_display->writeDisplay();
-            break;
+// Append the latest pipeline sample to the flight log
+static void logSample(const pipeline::Output& output) {
+    flightlog::append(toRecord(output));
+}
+
+// Keep the sample in the capture ring and trigger a capture on anything
+// worth seeing at full rate
+static void captureSample(const pipeline::Output& output) {
+    static bool wasValid = true;
+    if (!g_flightLogReady) {
+        return;
+    }
+    logformat::Record record = toRecord(output);
+    g_capture.add(record);
+    const char* trigger = capture::findTrigger(output, wasValid);
+    wasValid = output.valid;
+    if (trigger && g_capture.trigger(record.timeMs)) {
+        logger::log(logger::Msg::CaptureStarted, trigger, record.timeMs);
+    }
+}
+
+// Captured samples only take a page buffer while none is waiting for flash,
+// so they never crowd out regular logging
+static bool appendCaptured(const logformat::Record& record) {
+    return flightlog::getPendingPages() == 0 && flightlog::append(record);
+}
+
+// Flush captured samples from the idle loop. Returns true if more are ready.
+static bool serviceCapture() {
+    static bool wasActive = false;
+    bool busy = g_capture.service(appendCaptured);
+    if (wasActive && !g_capture.isActive()) {
+        logger::log(logger::Msg::CaptureFlushed, g_capture.getFlushedCount(), g_capture.getOverrunCount());
+    }
+    wasActive = g_capture.isActive();
+    return busy;
+}
+
+#if !PICO_ALTIMETER_REPLAY
+// Sensor buses and the addresses a BMP390 can strap to
+struct SensorBus {
+    i2c_inst_t* i2c;
+    uint sdaPin;
+    uint sclPin;
+};
+static const SensorBus SENSOR_BUSES[] = {
+    {i2c0, PIN_IC20_SDA, PIN_IC20_SCL},
+    {i2c1, PIN_IC12_SDA, PIN_IC12_SCL},
+};
+
+// Every place a sensor can be fitted, 0x77 and 0x76 on each bus, with its
+// driver and supervisor allocated statically. Only the slots whose sensor
+// answers the probe are used.
+struct SensorSlot {
+    SensorSlot(uint8_t bus, uint8_t address)
+        : bus(bus), address(address), sensor(SENSOR_BUSES[bus].i2c, address),
+          supervised(sensor, SENSOR_BUSES[bus].i2c, SENSOR_BUSES[bus].sdaPin, SENSOR_BUSES[bus].sclPin) {}
+
+    uint8_t bus;
+    uint8_t address;
+    bmp390::BMP390 sensor;
+    supervisor::Supervisor supervised;
+};
+static SensorSlot g_sensorSlots[] = {{0, 0x77}, {0, 0x76}, {1, 0x77}, {1, 0x76}};
+static_assert(sizeof(g_sensorSlots) / sizeof(g_sensorSlots[0]) <= sensorarray::MAX_SENSORS,
+              "the sensor array must have room for every slot");
+
+// Start a slot's sensor and add it to the array. Returns true if it started.
+static bool addSensor(sensorarray::SensorArray& sensors, SensorSlot& slot, bmp390::Profile profile) {
+    bool started = slot.supervised.begin(profile);
+    sensors.add(slot.supervised, slot.bus);
+    return started;
+}
+#endif
+
+#if PICO_ALTIMETER_REPLAY
+static uint32_t millisSinceBoot() {
+    return to_ms_since_boot(get_absolute_time());
+}
+#endif
+
+// Power-on display test, run as a task so the sensors are brought up and the
+// loop samples and handles input while it plays. Nothing else writes the
+// display until it finishes.
+static task::Task displaySelfTest(ht16k33::HT16K33& display) {
+    uint32_t holdMs;
+    for (uint32_t step = 0; (holdMs = display.testStep(step)) > 0; ++step) {
+        co_await task::sleepFor(holdMs);
+    }
+    g_selfTestRunning = false;
+}
+
+// Put the display buffer on the display. A frame drawn by the render task
+// goes out by DMA while the loop gets on with the next sensor read; anything
+// else is written straight away.
+static void showFrame() {
+    task::Completion* done = render::beginTransfer();
+    if (!done || !i2cbus::startWrite(i2c1, g_display->getAddress(), g_display->getFrame(), ht16k33::FRAME_BYTES,
+                                     *done)) {
+        i2cbus::Claim claim(i2c1);
+        g_display->writeDisplay();
+        if (done) {
+            done->signal();
         }
-        case DeviceState::Setting: {
-            int32_t position = encoder::getPosition();
-            // Display as inHg with two decimal places
-            g_display->displayNumber(position, 2);
-            g_display->setColon(true);
-            g_display->writeDisplay();
-            break;
+    }
+}
+
+// Show "EEEE" while there is no sensor to read
+static void displaySensorError() {
+    g_display->displayDigit(0, 0x0E);
+    g_display->displayDigit(1, 0x0E);
+    g_display->displayDigit(2, 0x0E);
+    g_display->displayDigit(3, 0x0E);
+    g_display->setColon(false);
+    showFrame();
+}
+
+static bool sensorRecovering() {
+#if PICO_ALTIMETER_REPLAY
+    return false;
+#else
+    return g_sensors && !g_sensors->isAvailable();
+#endif
+}
+
+// The altitude, or "EEEE" while no sensor is available
+static void drawAltitude() {
+    pipeline::Output output = g_pipeline.getOutput();
+    if (!output.valid) {
+        // Keep the last altitude up unless the sensors are gone
+        if (sensorRecovering()) {
+            displaySensorError();
         }
-        default:
-            printf("Unknown state in updateDisplay\n");
-            break;
+        return;
+    }
+    g_display->displayNumber(output.displayFeet);
+    g_display->setColon(false);
+    showFrame();
+}
+
+// Vertical speed in feet per minute, marked by the last decimal point
+static void drawVsi() {
+    pipeline::Output output = g_pipeline.getOutput();
+    if (!output.valid) {
+        if (sensorRecovering()) {
+            displaySensorError();
+        }
+        return;
+    }
+    g_display->displaySignedNumber(output.displayFeetPerMinute, 3);
+    g_display->setColon(false);
+    showFrame();
+}
+
+// The sea level setting being dialled in, as inHg with two decimal places
+static void drawSetting() {
+    g_display->displayNumber(encoder::getPosition(), 2);
+    g_display->setColon(true);
+    showFrame();
+}
+
+// Leaving Setting: adopt the dialled sea level pressure
+static void commitSeaLevel() {
+    double seaLevelPa = encoder::getPascals();
+    g_pipeline.setSeaLevelPressure(seaLevelPa);
+    flightlog::setSeaLevelPressure(seaLevelPa);
+    config::setSeaLevel(encoder::getPosition());
+    logger::log(logger::Msg::SeaLevelUpdated, seaLevelPa, encoder::getPosition() / 100.0);
+
+    render::LatencyStats latency = render::getStats();
+    if (latency.frames > 0) {
+        logger::log(logger::Msg::RenderLatency, latency.frames, latency.coalesced,
+                    latency.meanUs, latency.maxUs);
+    }
+}
+
+// Entering Setting: report how busy the buses were over the flying modes and
+// start the display's statistics afresh for the setting being dialled in.
+// Frames follow their sample's read there, so both buses are rarely busy at
+// once; the overlap counts the frames that do land on a read (input, the
+// self-test) and would show reads or frames running long enough to collide.
+static void reportBuses() {
+    i2cbus::Stats bus = i2cbus::getStats();
+    if (bus.elapsedUs > 0) {
+        double toPercent = 100.0 / bus.elapsedUs;
+        logger::log(logger::Msg::I2cUtilisation, bus.frames, bus.busyUs[0] * toPercent, bus.busyUs[1] * toPercent,
+                    bus.overlapUs * toPercent);
+        logger::log(logger::Msg::I2cPeak, bus.peakUtilisation[0] * 100.0, bus.peakUtilisation[1] * 100.0,
+                    bus.abandoned);
+    }
+    i2cbus::resetStats();
+    render::resetStats();
+}
+
+// Altimeter and VSI sample at the sensor's data rate for the flight event
+// detector and event capture, and log and draw at the configured rate. Both
+// keep the vertical speed estimate running, so switching between them shows
+// a settled value at once, and VSI reads the sensors no more often than
+// Altimeter.
+// Setting shows only the knob: no altitude is worked out and the display
+// follows the encoder, but samples are still taken (slowly) so the flight log
+// has no hole and the sensor supervisor keeps the watchdog fed.
+static constexpr mode::Spec MODES[] = {
+    {mode::Mode::Altimeter,
+     mode::STAGE_ACQUIRE | mode::STAGE_ESTIMATE | mode::STAGE_DETECT | mode::STAGE_CAPTURE | mode::STAGE_LOG |
+         mode::STAGE_DISPLAY_SAMPLES,
+     0, drawAltitude},
+    {mode::Mode::Vsi,
+     mode::STAGE_ACQUIRE | mode::STAGE_ESTIMATE | mode::STAGE_DETECT | mode::STAGE_CAPTURE | mode::STAGE_LOG |
+         mode::STAGE_DISPLAY_SAMPLES,
+     0, drawVsi},
+    {mode::Mode::Setting, mode::STAGE_ACQUIRE | mode::STAGE_LOG | mode::STAGE_DISPLAY_INPUT, 1000, drawSetting},
+};
+static_assert(mode::specsComplete(MODES), "MODES must have one spec per mode, in order");
+
+static constexpr mode::Transition TRANSITIONS[] = {
+    {mode::Mode::Altimeter, mode::Input::Button, mode::Mode::Vsi, logger::Msg::ModeVsi, nullptr},
+    {mode::Mode::Vsi, mode::Input::Button, mode::Mode::Setting, logger::Msg::ModeSetting, reportBuses},
+    {mode::Mode::Setting, mode::Input::Button, mode::Mode::Altimeter, logger::Msg::ModeAltimeter, commitSeaLevel},
+};
+static_assert(mode::transitionsValid(TRANSITIONS), "TRANSITIONS has an invalid or duplicate entry");
+
+static const mode::Spec& currentMode() {
+    return MODES[mode::index(g_mode)];
+}
+
+// How often the mode logs and draws
+static uint32_t displayPeriodMs(const mode::Spec& spec) {
+    return spec.minSamplePeriodMs > g_configuredPeriodMs ? spec.minSamplePeriodMs : g_configuredPeriodMs;
+}
+
+// How often the mode samples: as often as the sensor has new data if it
+// detects flight events
+static uint32_t samplePeriodMs(const mode::Spec& spec) {
+    uint32_t period = displayPeriodMs(spec);
+    if ((spec.stages & mode::STAGE_DETECT) && g_sensorPeriodMs < period) {
+        period = g_sensorPeriodMs;
+    }
+    return period;
+}
+
+#if !PICO_ALTIMETER_REPLAY
+// Longest gap between samples in any mode
+static uint32_t slowestSamplePeriodMs() {
+    uint32_t slowest = 0;
+    for (const mode::Spec& spec : MODES) {
+        slowest = samplePeriodMs(spec) > slowest ? samplePeriodMs(spec) : slowest;
+    }
+    return slowest;
+}
+#endif
+
+// Draw the current mode. Called by the render task; nothing is drawn over
+// the self-test.
+static void drawDisplay() {
+    if (!g_selfTestRunning) {
+        currentMode().draw();
+    }
+}
+
+// Hand a detection to the event loop, which logs it
+static void postFlightEvent(flightevents::Event detected) {
+    static constexpr event::EventType TYPES[] = {
+        event::EventType::None, event::EventType::Launch, event::EventType::Apogee, event::EventType::Landing};
+    int32_t heightFeet = static_cast<int32_t>(lround(g_pipeline.getLastDetection().altitudeFeet));
+    event::queueEvent(event::Event(TYPES[static_cast<size_t>(detected)], heightFeet));
+}
+
+// Weather summary each time the coarsest history level gains an entry: the
+// latest mean, the barometric tendency (3 h) and the trend over the last day
+static void logPressureHistory() {
+    constexpr uint32_t TENDENCY_MS = 3 * 3600 * 1000;
+    constexpr size_t DAY_LEVEL = 1;
+    logger::log(logger::Msg::PressureHistory, g_history.get(history::LEVEL_COUNT - 1, 0).meanPa / 100.0,
+                g_history.getTendencyPa(TENDENCY_MS) / 100.0, g_history.getTrendPaPerHour(DAY_LEVEL) / 100.0);
+}
+
+#if !PICO_ALTIMETER_REPLAY
+// Time the next sample to land just after the lead sensor's next conversion
+// rather than at whatever phase the timer happens to have. Only while the
+// mode samples at the sensor's data rate, once per conversion.
+static void lockPhase() {
+    const supervisor::Supervisor* lead = g_sensors->getLead();
+    if (!lead || samplePeriodMs(currentMode()) != g_sensorPeriodMs) {
+        return;
+    }
+    const bmp390::BMP390& sensor = lead->getSensor();
+
+    // Each sensor follows its own conversions' phase through its reads (and
+    // starts again when it is restarted)
+    const phaselock::PhaseLock& lock = sensor.getPhaseLock();
+    if (lock.isLocked() && !g_phaseLocked) {
+        logger::log(logger::Msg::PhaseLocked,
+                    static_cast<uint32_t>(lock.getPeriodTicks() * sensor.getUsPerTick()),
+                    static_cast<uint32_t>(lock.getAgeTicks() * sensor.getUsPerTick()));
+    } else if (g_phaseLocked && !lock.isLocked()) {
+        logger::log(logger::Msg::PhaseLost, lock.getStaleCount());
+    }
+    g_phaseLocked = lock.isLocked();
+
+    // Keep the time from tick to read the same for the next sample. Samples
+    // not started by a tick (a mode change) leave the timer alone.
+    int64_t latencyUs = static_cast<int64_t>(sensor.toMcuUs(sensor.getSensorTicks()) - timer::getLastTickUs());
+    if (latencyUs < 0 || latencyUs > static_cast<int64_t>(g_sensorPeriodMs) * 1000 / 4) {
+        return;
     }
+    timer::setNextAt(sensor.toMcuUs(lock.getNextReadTicks()) - latencyUs);
+}
+#endif
+
+// Take a sample and do what the mode needs with it
+void updateDisplay() {
+    if (!g_source || !g_display) return;
+
+    uint8_t stages = currentMode().stages;
+    if (!(stages & mode::STAGE_ACQUIRE)) {
+        return;
+    }
+
+    // Faster samples (for the detector) are logged and drawn once a period.
+    // The frame of this sample is started as soon as it is estimated, so its
+    // write to the display (i2c1) runs under the logging and capture below.
+    // It does not overlap a sensor read: the next is a sensor period away,
+    // and holding the frame for it would show every sample that much late
+    // for about 1.4 ms of bus overlap.
+    bool periodSample = g_sampleCount++ % g_samplesPerPeriod == 0;
+    if (periodSample) {
+        i2cbus::endFrame();
+    }
+
+    pipeline::Output output = g_pipeline.step(*g_source, to_ms_since_boot(get_absolute_time()));
+    probe::mark(probe::Stage::Estimate);
+    if (periodSample && (stages & mode::STAGE_DISPLAY_SAMPLES)) {
+        render::request();
+        task::run();
+    }
+#if !PICO_ALTIMETER_REPLAY
+    lockPhase();
+#endif
+    if (output.outlier) {
+        logger::log(logger::Msg::SampleOutlier, output.pressurePa, g_pipeline.getOutlierCount());
+    }
+    if (output.flightEvent != flightevents::Event::None) {
+        postFlightEvent(output.flightEvent);
+    }
+    if (stages & mode::STAGE_CAPTURE) {
+        captureSample(output);
+    }
+    if (output.valid && g_history.add(output.timeMs, output.pressurePa) == history::LEVEL_COUNT) {
+        logPressureHistory();
+    }
+
+    if (!periodSample) {
+        return;
+    }
+    if (stages & mode::STAGE_LOG) {
+        logSample(output);
+    }
+    if ((stages & mode::STAGE_DISPLAY_SAMPLES) && !output.valid) {
+        logger::log(logger::Msg::SensorReadFailed);
+    }
+}
+
+// Work out the mode's sample period and how many samples make a display
+// period; the next sample is logged and drawn. Returns the sample period.
+static uint32_t startSampling(const mode::Spec& spec) {
+    uint32_t periodMs = samplePeriodMs(spec);
+    g_samplesPerPeriod = (displayPeriodMs(spec) + periodMs / 2) / periodMs;
+    g_samplesPerPeriod = g_samplesPerPeriod > 0 ? g_samplesPerPeriod : 1;
+    g_sampleCount = 0;
+    return periodMs;
+}
+
+// Switch to a mode and apply its policy: sample rate, estimation, and a
+// first sample and frame straight away rather than a period later
+static void enterMode(mode::Mode next) {
+    g_mode = next;
+    const mode::Spec& spec = currentMode();
+    timer::setInterval(startSampling(spec));
+    g_pipeline.setEstimating(spec.stages & mode::STAGE_ESTIMATE);
+    updateDisplay();
+    render::request();
 }
 
 // Handle timer event based on current state
 void handleTimerEvent() {
-    if (!g_sensor || !g_display) return;
+    if (!g_source || !g_display) return;
     updateDisplay(); 
 }
 
+// Log a flight event with when it happened and how long detecting it took
+void handleFlightEvent(event::EventType type) {
+    const flightevents::Detection& detection = g_pipeline.getLastDetection();
+    uint32_t eventMs = static_cast<uint32_t>(detection.eventUs / 1000);
+    uint32_t delayMs = static_cast<uint32_t>((detection.detectedUs - detection.eventUs) / 1000);
+    if (type == event::EventType::Launch) {
+        logger::log(logger::Msg::FlightLaunch, detection.altitudeFeet, eventMs);
+    } else if (type == event::EventType::Apogee) {
+        logger::log(logger::Msg::FlightApogee, detection.altitudeFeet, eventMs, delayMs);
+    } else {
+        logger::log(logger::Msg::FlightLanding, detection.altitudeFeet, eventMs, delayMs);
+    }
+}
+
 // Handle encoder rotation event
 void handleEncoderEvent(int32_t delta) {
     int32_t position = encoder::getPosition();
-    printf("Encoder: delta=%d, position=%d, state=%d\n", (int)delta, (int)position, (int)g_state);
+    logger::log(logger::Msg::EncoderChange, delta, position, (int)g_mode);
+
+    // Show the new setting now rather than on the next tick
+    if (currentMode().stages & mode::STAGE_DISPLAY_INPUT) {
+        render::requestForInput(encoder::getChangeTimeUs());
+    }
 }
 
-// Handle button press event - toggle state
+// Handle button press event - follow the mode's transition
 void handleButtonEvent() {
-    if (!g_sensor || !g_display) return;
-
-    switch(g_state) {
-        case DeviceState::Altimeter:
-            printf("Button pressed: switching to SETTING mode\n");
-            g_state = DeviceState::Setting;
-            break;
-        case DeviceState::Setting:
-            printf("Button pressed: switching to ALTIMETER mode\n");
-            {
-                // Update sensor with new sea level pressure
-                double seaLevelPa = encoder::getPascals();
-                g_sensor->setSeaLevelPressure(seaLevelPa);
-                printf("Updated sea level pressure to %.2f Pa (%.2f inHg)\n", seaLevelPa, encoder::getPosition() / 100.0);
-            }
-            g_state = DeviceState::Altimeter;
-            break;
-        default:
-            printf("Unknown state in button handler\n");
-            break;
+    if (!g_source || !g_display) return;
+
+    const mode::Transition* transition = mode::find(TRANSITIONS, g_mode, mode::Input::Button);
+    if (!transition) {
+        return;
+    }
+    logger::log(transition->message);
+    if (transition->action) {
+        transition->action();
     }
+    enterMode(transition->to);
 }
 
 int main()
 {
     stdio_init_all();
+    logger::initLogger();
     initializePins();
+    probe::init();
+    i2cbus::init();
     
     // Initialize event queue first
     event::initEventQueue();
+
+    // Restore the saved configuration (or defaults)
+    const config::Settings& settings = config::initConfig();
     
     // Initialize display with i2c1 instance
     ht16k33::HT16K33 display(i2c1);
     display.begin();
     g_display = &display;
 
-    // Test the display
-    display.testDisplay();
-
-    // Try to initialize BMP390 sensor
-    printf("Trying BMP390 at address 0x77 on i2c0...\n");
-    bmp390::BMP390 sensor(i2c0, 0x77);
-    if (!sensor.begin()) {
-        printf("Failed to initialize BMP390 sensor!\n");
-        display.displayDigit(0, 0x0E); // Display 'E' for error
-        display.displayDigit(1, 0x0E);
-        display.displayDigit(2, 0x0E);
-        display.displayDigit(3, 0x0E);
-        display.writeDisplay();
-        return -1;
-    }
-    g_sensor = &sensor;
-    printf("BMP390 sensor initialized successfully!\n");
-
-    // Initialize encoder with default pressure setting (29.92 inHg)
+    // Test the display in the background (or here, if the task cannot start)
+    g_selfTestRunning = true;
+    if (!task::spawn(displaySelfTest(display))) {
+        g_selfTestRunning = false;
+        display.testDisplay();
+    }
+    render::start(drawDisplay);
+
+#if PICO_ALTIMETER_REPLAY
+    // Play back the recorded flight log in real time instead of reading the
+    // sensor. Nothing is logged, so the log being played is left intact.
+    // Static: the decoded page buffer is too big for the main stack.
+    static replay::ReplaySource replaySource(
+        flashwrite::map(flashmap::FLIGHTLOG_OFFSET), flashmap::FLIGHTLOG_SIZE,
+        {replay::Pacing::RealTime, millisSinceBoot, true});
+    logger::log(replaySource.finished() ? logger::Msg::ReplayEmpty : logger::Msg::ReplayStarted);
+    g_source = &replaySource;
+#else
+    // Find the sensors (0x77 and 0x76 on both buses) and read them as one
+    // fused source. A sensor that fails to start is retried in the
+    // background by its supervisor; the display shows "EEEE" until one is up.
+    logger::log(logger::Msg::SensorProbe);
+    static sensorarray::SensorArray sensors;
+    bmp390::Profile profile = static_cast<bmp390::Profile>(settings.sensorProfile);
+    bool anyStarted = false;
+    for (SensorSlot& slot : g_sensorSlots) {
+        if (!sensorarray::probe(SENSOR_BUSES[slot.bus].i2c, slot.address)) {
+            continue;
+        }
+        logger::log(logger::Msg::SensorFound, slot.bus, slot.address);
+        anyStarted |= addSensor(sensors, slot, profile);
+    }
+    if (sensors.getCount() == 0) {
+        // Nothing answered: supervise the usual sensor (0x77 on i2c0) so it
+        // is picked up if it starts responding
+        addSensor(sensors, g_sensorSlots[0], profile);
+    }
+    if (anyStarted) {
+        logger::log(logger::Msg::SensorReady, static_cast<uint32_t>(sensors.getCount()));
+    } else {
+        logger::log(logger::Msg::SensorInitAborted);
+        displaySensorError();
+    }
+    g_sensors = &sensors;
+    g_source = &sensors;
+#endif
+
+    // Initialize encoder with the saved pressure setting
     encoder::initEncoder();
-    encoder::setPosition(DEFAULT_PRESSURE_INHG_X100);
-    printf("Encoder initialized to %d (%.2f inHg)\n", 
-           DEFAULT_PRESSURE_INHG_X100, DEFAULT_PRESSURE_INHG_X100 / 100.0);
+    encoder::setPosition(settings.seaLevelInHgX100);
+    g_pipeline.setSeaLevelPressure(encoder::getPascals());
+    logger::log(logger::Msg::EncoderInitialized,
+                settings.seaLevelInHgX100, settings.seaLevelInHgX100 / 100.0);
+
+#if !PICO_ALTIMETER_REPLAY
+    // Resume the flight log after the last page found in flash
+    g_flightLogReady = flightlog::initFlightLog();
+    flightlog::setSeaLevelPressure(g_pipeline.getSeaLevelPressure());
+#endif
 
-    // Start the timer (250ms = 4 updates per second)
-    timer::initTimer(250);
-    printf("Timer started\n");
+    // Start the timer at the starting mode's rate: the sensor's data rate
+    // for the detector, drawing every 250ms by default
+    g_configuredPeriodMs = settings.displayPeriodMs;
+    g_sensorPeriodMs = bmp390::outputPeriodUs(static_cast<bmp390::Profile>(settings.sensorProfile)) / 1000;
+    timer::initTimer(startSampling(currentMode()));
+    logger::log(logger::Msg::TimerStarted);
 
-    printf("Entering event loop in ALTIMETER mode...\n");
-    printf("Press button to switch to SETTING mode\n");
+#if !PICO_ALTIMETER_REPLAY
+    // From here on the supervisor must see samples (or recovery attempts)
+    // regularly or the watchdog restarts the device
+    supervisor::enableWatchdog(slowestSamplePeriodMs());
+#endif
+
+    logger::log(logger::Msg::LoopStarted);
+    logger::log(logger::Msg::LoopHint);
 
     // Main event loop
     while (true) {
-        event::Event evt = event::waitForEvent();
+        event::Event evt = event::tryGetEvent();
+        if (evt.type == event::EventType::None) {
+            // Idle: the last sample was just taken, so this is the longest quiet
+            // time for flash work. Then let the deferred logger use the UART.
+            bool busy = flightlog::service();
+            busy |= serviceCapture();
+            busy |= i2cbus::service();
+#if !PICO_ALTIMETER_REPLAY
+            busy |= g_sensors->service();
+#endif
+            config::service();
+            busy |= task::run();
+            busy |= logger::service();
+            if (busy) {
+                continue;
+            }
+            evt = event::waitForEvent();
+        }
         
         switch (evt.type) {
             case event::EventType::Timer:
@@ -152,11 +621,21 @@ int main()
             case event::EventType::ButtonPress:
                 handleButtonEvent();
                 break;
+
+            case event::EventType::TaskWake:
+                task::run();
+                break;
+
+            case event::EventType::Launch:
+            case event::EventType::Apogee:
+            case event::EventType::Landing:
+                handleFlightEvent(evt.type);
+                break;
                 
             case event::EventType::None:
             default:
                 // Should not happen
-                printf("Received unknown event type %d in main loop\n", (int)evt.type);
+                logger::log(logger::Msg::UnknownEvent, (int)evt.type);
                 break;
         }
     }
@@ -0,0 +1,102 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "logger.h"
+
+// Device modes as tables. Each mode declares the work it needs (stages) and
+// how often to sample; each transition names the mode it leaves, the input
+// that triggers it, where it goes and what to do on the way. The tables are
+// constexpr and checked at compile time, so a mode without a spec or two
+// transitions for the same input do not build.
+namespace mode {
+
+enum class Mode : uint8_t {
+    Altimeter,  // Display altitude
+    Vsi,        // Display vertical speed
+    Setting,    // Display/adjust sea level pressure
+    Count
+};
+
+enum class Input : uint8_t {
+    Button,     // Encoder button pressed
+    Count
+};
+
+// Stages a mode needs, as bits
+constexpr uint8_t STAGE_ACQUIRE = 0x01;         // Read the sensors on the sample timer
+constexpr uint8_t STAGE_ESTIMATE = 0x02;        // Compute altitude and vertical speed from each sample
+constexpr uint8_t STAGE_LOG = 0x04;             // Append each sample to the flight log
+constexpr uint8_t STAGE_DISPLAY_SAMPLES = 0x08; // Redraw after each sample
+constexpr uint8_t STAGE_DISPLAY_INPUT = 0x10;   // Redraw when the encoder turns
+constexpr uint8_t STAGE_DETECT = 0x20;          // Sample at the sensor's data rate for the flight
+                                                // event detector; log and redraw still follow
+                                                // the configured period
+constexpr uint8_t STAGE_CAPTURE = 0x40;         // Keep every sample for event capture and trigger it
+                                                // on flight events, rapid descent and sensor faults
+
+using Action = void (*)();
+
+struct Spec {
+    Mode mode;
+    uint8_t stages;
+    uint32_t minSamplePeriodMs;  // Slowest of this and the configured period (unless detecting)
+    Action draw;                 // Puts the mode's state on the display
+};
+
+struct Transition {
+    Mode from;
+    Input input;
+    Mode to;
+    logger::Msg message;        // Logged when taken
+    Action action;              // Run before entering the new mode (may be null)
+};
+
+constexpr size_t index(Mode mode) {
+    return static_cast<size_t>(mode);
+}
+
+// Every mode has exactly one spec, at its own index
+template <size_t N>
+constexpr bool specsComplete(const Spec (&specs)[N]) {
+    if (N != index(Mode::Count)) {
+        return false;
+    }
+    for (size_t i = 0; i < N; ++i) {
+        if (index(specs[i].mode) != i || !specs[i].draw) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Transitions name real modes and inputs, and no mode has two for one input
+template <size_t N>
+constexpr bool transitionsValid(const Transition (&transitions)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+        const Transition& t = transitions[i];
+        if (t.from >= Mode::Count || t.to >= Mode::Count || t.input >= Input::Count) {
+            return false;
+        }
+        for (size_t j = i + 1; j < N; ++j) {
+            if (transitions[j].from == t.from && transitions[j].input == t.input) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// The transition taken on input in mode from, or nullptr if it is ignored
+template <size_t N>
+constexpr const Transition* find(const Transition (&transitions)[N], Mode from, Input input) {
+    for (size_t i = 0; i < N; ++i) {
+        if (transitions[i].from == from && transitions[i].input == input) {
+            return &transitions[i];
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace mode
@@ -0,0 +1,93 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "outlier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace outlier {
+
+Hampel::Hampel(double threshold, double minDeviation)
+    : threshold(threshold), minDeviation(minDeviation), rejected(0) {
+    reset();
+}
+
+void Hampel::reset() {
+    head = 0;
+    count = 0;
+    outlier = false;
+}
+
+double Hampel::filter(double value) {
+    // Drop the oldest sample from the sorted copy
+    if (count == WINDOW) {
+        size_t index = std::lower_bound(sorted, sorted + count, ring[head]) - sorted;
+        memmove(&sorted[index], &sorted[index + 1], (count - 1 - index) * sizeof(sorted[0]));
+        count--;
+    }
+    size_t index = std::upper_bound(sorted, sorted + count, value) - sorted;
+    memmove(&sorted[index + 1], &sorted[index], (count - index) * sizeof(sorted[0]));
+    sorted[index] = value;
+    count++;
+    ring[head] = value;
+    head = (head + 1) % WINDOW;
+
+    outlier = false;
+    if (count < WINDOW) {
+        return value;
+    }
+    double median = getMedian();
+    double limit = std::max(threshold * MAD_TO_SIGMA * getMad(), minDeviation);
+    if (fabs(value - median) > limit) {
+        outlier = true;
+        rejected++;
+        return median;
+    }
+    return value;
+}
+
+double Hampel::getMedian() const {
+    if (count == 0) {
+        return NAN;
+    }
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+}
+
+double Hampel::getMad() const {
+    if (count == 0) {
+        return NAN;
+    }
+    double median = getMedian();
+    return count % 2 ? deviation(count / 2, median)
+                     : (deviation(count / 2 - 1, median) + deviation(count / 2, median)) / 2.0;
+}
+
+// Distances from the median form two sorted runs: going down from it
+// (below) and going up from it (above). The k-th smallest of the two is found
+// by bisecting how many of the k + 1 smallest come from below.
+double Hampel::deviation(size_t k, double median) const {
+    size_t split = std::lower_bound(sorted, sorted + count, median) - sorted;
+    size_t belowCount = split;
+    size_t aboveCount = count - split;
+    auto below = [&](size_t i) { return median - sorted[split - 1 - i]; };
+    auto above = [&](size_t i) { return sorted[split + i] - median; };
+
+    size_t take = k + 1;
+    size_t low = take > aboveCount ? take - aboveCount : 0;
+    size_t high = std::min(take, belowCount);
+    while (true) {
+        size_t a = (low + high) / 2;
+        size_t b = take - a;
+        if (a > 0 && b < aboveCount && below(a - 1) > above(b)) {
+            high = a - 1;
+        } else if (b > 0 && a < belowCount && above(b - 1) > below(a)) {
+            low = a + 1;
+        } else {
+            double fromBelow = a > 0 ? below(a - 1) : 0.0;
+            double fromAbove = b > 0 ? above(b - 1) : 0.0;
+            return std::max(fromBelow, fromAbove);
+        }
+    }
+}
+
+}  // namespace outlier
@@ -0,0 +1,68 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Outlier rejection for single bad samples: a glitched read, a door slam,
+// prop wash. A causal Hampel filter compares each sample with the median of
+// the last WINDOW samples (itself included) and replaces it with that median
+// if it is further away than THRESHOLD scaled median absolute deviations.
+// The window is kept sorted as well as in arrival order, so a sample costs
+// two binary searches, a short block move and an O(log N) selection for the
+// MAD; no sorting. A real change (a launch, a climb) passes once it fills
+// half the window. Static storage, no SDK dependencies.
+namespace outlier {
+
+// Samples in the window (odd, so the median is a sample)
+constexpr size_t WINDOW = 9;
+static_assert(WINDOW % 2 == 1, "WINDOW must be odd");
+
+// Deviation allowed, in MADs scaled to standard deviations (1.4826 MAD is
+// one sigma for Gaussian noise)
+constexpr double THRESHOLD = 3.0;
+constexpr double MAD_TO_SIGMA = 1.4826;
+
+// Smallest deviation ever rejected, in pascals (about 2 ft, six times the
+// sensor's noise), so a quiet window with a small MAD does not reject
+// ordinary noise. Set from replayed flights: fewer than 0.1% of samples are
+// rejected, against 2% with no floor.
+constexpr double MIN_DEVIATION_PA = 8.0;
+
+class Hampel {
+public:
+    Hampel(double threshold = THRESHOLD, double minDeviation = MIN_DEVIATION_PA);
+
+    // Forget the window (the rejection count is kept)
+    void reset();
+
+    // Add a sample. Returns it, or the window median if it is an outlier.
+    // Nothing is rejected until the window is full.
+    double filter(double value);
+
+    // Whether the last sample was rejected
+    bool wasOutlier() const { return outlier; }
+
+    // Median and median absolute deviation of the window
+    double getMedian() const;
+    double getMad() const;
+
+    uint32_t getRejectedCount() const { return rejected; }
+
+private:
+    // k-th smallest (from 0) distance from the median
+    double deviation(size_t k, double median) const;
+
+    double threshold;
+    double minDeviation;
+
+    double ring[WINDOW];        // Arrival order; head is the oldest once full
+    double sorted[WINDOW];
+    size_t head;
+    size_t count;
+
+    bool outlier;
+    uint32_t rejected;
+};
+
+}  // namespace outlier
@@ -0,0 +1,139 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "phaselock.h"
+
+namespace phaselock {
+
+PhaseLock::PhaseLock() : stale(0) {
+    reset(1);
+}
+
+void PhaseLock::reset(uint32_t periodTicks) {
+    period = periodTicks > 0 ? periodTicks : 1;
+    start = 0;
+    width = period;
+    haveRead = false;
+    lastTicks = 0;
+    creep = 0;
+    lockedReads = 0;
+}
+
+// Narrow the ready phase to its overlap with other. Returns false, leaving
+// it alone, if there is none. An overlap in two pieces (other only rules out
+// the middle) leaves it alone too: the phase may be in either.
+bool PhaseLock::intersect(Arc other) {
+    if (width == period) {
+        start = other.start % period;
+        width = other.length;
+        return true;
+    }
+    // other relative to start: (offset, offset + other.length], which may
+    // run past the end of the period and wrap to (0, ...]
+    uint32_t offset = (other.start + period - start) % period;
+    uint32_t end = offset + other.length;
+
+    uint32_t firstLength = 0;
+    if (offset < width) {
+        firstLength = (end < width ? end : width) - offset;
+    }
+    uint32_t wrappedLength = 0;
+    if (end > period) {
+        wrappedLength = end - period < width ? end - period : width;
+    }
+
+    if (firstLength == 0 && wrappedLength == 0) {
+        return false;
+    }
+    if (firstLength > 0 && wrappedLength > 0) {
+        return true;
+    }
+    if (firstLength > 0) {
+        start = (start + offset) % period;
+        width = firstLength;
+    } else {
+        width = wrappedLength;
+    }
+    return true;
+}
+
+void PhaseLock::update(uint64_t ticks, bool fresh) {
+    if (!fresh) {
+        stale++;
+    }
+    if (!haveRead || ticks <= lastTicks) {
+        haveRead = true;
+        lastTicks = ticks;
+        return;
+    }
+    uint64_t gap = ticks - lastTicks;
+    uint32_t lastPhase = static_cast<uint32_t>(lastTicks % period);
+    uint32_t phase = static_cast<uint32_t>(ticks % period);
+    lastTicks = ticks;
+
+    if (gap < period) {
+        // New data: ready since the last read. None: ready after this read,
+        // but no later than a period after the last.
+        Arc bracket = fresh ? Arc{lastPhase, static_cast<uint32_t>(gap)}
+                            : Arc{phase, period - static_cast<uint32_t>(gap)};
+        bool wasLocked = isLocked();
+        if (!intersect(bracket)) {
+            // The phase moved (or the sensor restarted): start from here
+            start = bracket.start;
+            width = bracket.length;
+        }
+        if (!fresh || !wasLocked) {
+            creep = 0;
+            lockedReads = 0;
+        }
+    } else if (!fresh) {
+        // A whole period without new data: the phase is unknown again
+        start = 0;
+        width = period;
+        creep = 0;
+    }
+
+    if (isLocked() && fresh && ++lockedReads % CREEP_READS == 0) {
+        creep++;
+    }
+}
+
+// Phase to read at: the middle of the ready phase while locating it, just
+// after its end once locked
+uint32_t PhaseLock::aimPhase() const {
+    if (!isLocked()) {
+        // A read just after the last one would come a period and more later
+        // and tell nothing, so go half way round first
+        uint32_t middle = (start + width / 2) % period;
+        uint32_t lastPhase = static_cast<uint32_t>(lastTicks % period);
+        if ((middle + period - lastPhase) % period < MIN_GAP_TICKS) {
+            return (lastPhase + period / 2) % period;
+        }
+        return middle;
+    }
+    return (start + width + MARGIN_TICKS + period - creep % period) % period;
+}
+
+uint64_t PhaseLock::getNextReadTicks() const {
+    uint64_t earliest = lastTicks + (isLocked() ? period / 2 : MIN_GAP_TICKS);
+    uint32_t ahead = (aimPhase() + period - static_cast<uint32_t>(earliest % period)) % period;
+    return earliest + ahead;
+}
+
+uint32_t PhaseLock::getAgeTicks() const {
+    if (!isLocked() || !haveRead) {
+        return 0;
+    }
+    return static_cast<uint32_t>((lastTicks + period - (start + width) % period) % period);
+}
+
+uint64_t PhaseLock::getReadyTicks() const {
+    if (width == period) {
+        // Any time in the last period: its middle is out by half at most
+        return lastTicks > period / 2 ? lastTicks - period / 2 : 0;
+    }
+    uint32_t middle = (start + (width + 1) / 2) % period;
+    uint32_t back = (static_cast<uint32_t>(lastTicks % period) + period - middle) % period;
+    return lastTicks > back ? lastTicks - back : 0;
+}
+
+}  // namespace phaselock
@@ -0,0 +1,85 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+// Reads locked to the sensor's conversions. The BMP390 runs its conversions
+// from its own oscillator, the same one that drives the sensor time, so new
+// data is ready at a fixed phase of the sensor time's output period. Each
+// read tells whether new data had arrived since the read before (the data
+// ready flags). Two reads less than a period apart therefore bracket the
+// phase: new data means it lies between them, none means it lies between
+// the second and a period after the first. Reads are first spaced to bisect
+// the phase; once it is known to within LOCK_TICKS, each read is aimed
+// MARGIN_TICKS after it, so the data read is always the newest and at most
+// a fraction of a millisecond old. All times are unwrapped sensor ticks
+// (sensortime::Clock converts them to the MCU clock). No SDK dependencies.
+namespace phaselock {
+
+// Ready phase known to within this many ticks (8 ticks = 312 us) to lock
+constexpr uint32_t LOCK_TICKS = 8;
+
+// Locked reads are aimed this far after the latest the data can be ready
+// (16 ticks = 625 us), for the jitter in when the loop gets to the read
+constexpr uint32_t MARGIN_TICKS = 16;
+
+// Shortest gap between reads while locating the phase, about a burst read
+// at 100 kHz (51 ticks = 2 ms)
+constexpr uint32_t MIN_GAP_TICKS = 51;
+
+// Once locked, aim a tick earlier every CREEP_READS reads. If the phase has
+// moved, a read eventually finds no new data and locates it again; if not,
+// that happens about every 20 seconds at 12.5 Hz.
+constexpr uint32_t CREEP_READS = 16;
+
+class PhaseLock {
+public:
+    PhaseLock();
+
+    // Start again, for a sensor with new data every periodTicks
+    void reset(uint32_t periodTicks);
+
+    // Add a read taken at ticks, and whether it found new data
+    void update(uint64_t ticks, bool fresh);
+
+    // When to take the read after the last one: the next bisecting point
+    // while locating the phase, a period on (just after new data) once locked
+    uint64_t getNextReadTicks() const;
+
+    bool isLocked() const { return width <= LOCK_TICKS; }
+
+    // How long the data had been ready at the last read, at most (0 unless
+    // locked)
+    uint32_t getAgeTicks() const;
+
+    // When the data found by the last read was ready, as near as the phase
+    // is known: the middle of the ready phase's last occurrence up to the
+    // read. Within LOCK_TICKS / 2 once locked, half a period at worst.
+    uint64_t getReadyTicks() const;
+
+    uint32_t getPeriodTicks() const { return period; }
+
+    // Reads that found no new data
+    uint32_t getStaleCount() const { return stale; }
+
+private:
+    // An arc of the period: the phases after start, up to start + length
+    struct Arc {
+        uint32_t start;
+        uint32_t length;
+    };
+
+    bool intersect(Arc other);
+    uint32_t aimPhase() const;
+
+    uint32_t period;
+    uint32_t start;         // Ready phase lies in (start, start + width]
+    uint32_t width;
+    bool haveRead;
+    uint64_t lastTicks;
+    uint32_t creep;         // Ticks the aim has moved earlier since locking
+    uint32_t lockedReads;
+    uint32_t stale;
+};
+
+}  // namespace phaselock
@@ -4,14 +4,22 @@
 #include "hardware/i2c.h"
 #include "pins.h"
 
+// Both buses run at 100 kHz
+constexpr uint I2C_BAUD_HZ = 100 * 1000;
+
+// Half an SCL period at the bus rate
+constexpr uint32_t BUS_CLEAR_HALF_PERIOD_US = 5;
+
+// A device can be at most one byte plus the ACK into a transfer
+constexpr int BUS_CLEAR_MAX_CLOCKS = 9;
 
 void initializePins() {
     
     // Initialize I2C0 (pins 12/13)
-    i2c_init(i2c0, 100 * 1000); //
+    i2c_init(i2c0, I2C_BAUD_HZ);
 
     // Initialize I2C1 (pins 14/15)
-    i2c_init(i2c1, 100 * 1000); // 100kHz
+    i2c_init(i2c1, I2C_BAUD_HZ);
 
     // Initialize GPIO pins for encoder
     gpio_init(PIN_GPIO_ENCODER_CLOCK);
@@ -35,4 +43,35 @@ void initializePins() {
     gpio_set_function(PIN_IC12_SDA, GPIO_FUNC_I2C);     
     gpio_pull_up(PIN_IC12_SDA);
     gpio_pull_up(PIN_IC12_SCL);
-}
\ No newline at end of file
+}
+
+bool recoverI2cBus(i2c_inst_t* i2c, uint sdaPin, uint sclPin) {
+    // Bit-bang the pins open drain: output low, or input to let the pull-up
+    // take the line high
+    gpio_init(sdaPin);
+    gpio_init(sclPin);
+    gpio_put(sdaPin, false);
+    gpio_put(sclPin, false);
+
+    for (int i = 0; i < BUS_CLEAR_MAX_CLOCKS && !gpio_get(sdaPin); ++i) {
+        gpio_set_dir(sclPin, GPIO_OUT);
+        sleep_us(BUS_CLEAR_HALF_PERIOD_US);
+        gpio_set_dir(sclPin, GPIO_IN);
+        sleep_us(BUS_CLEAR_HALF_PERIOD_US);
+    }
+
+    // START then STOP (SDA falls, then rises, with SCL high) resets the
+    // device's bus state machine
+    gpio_set_dir(sdaPin, GPIO_OUT);
+    sleep_us(BUS_CLEAR_HALF_PERIOD_US);
+    gpio_set_dir(sdaPin, GPIO_IN);
+    sleep_us(BUS_CLEAR_HALF_PERIOD_US);
+    bool released = gpio_get(sdaPin);
+
+    i2c_init(i2c, I2C_BAUD_HZ);
+    gpio_set_function(sclPin, GPIO_FUNC_I2C);
+    gpio_set_function(sdaPin, GPIO_FUNC_I2C);
+    gpio_pull_up(sdaPin);
+    gpio_pull_up(sclPin);
+    return released;
+}
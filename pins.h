@@ -1,6 +1,8 @@
 // (C) Alan Ludwig 2026 All rights reserved.
 #pragma once
 
+typedef struct i2c_inst i2c_inst_t;
+
 constexpr uint PIN_GPIO_ENCODER_CLOCK = 2;
 constexpr uint PIN_GPIO_ENCODER_DATA = 3;
 constexpr uint PIN_GPIO_ENCODER_BUTTON = 4;    
@@ -9,4 +11,13 @@ constexpr uint PIN_IC20_SCL = 13;
 constexpr uint PIN_IC12_SDA = 14;
 constexpr uint PIN_IC12_SCL = 15;
 
-void initializePins();
\ No newline at end of file
+// Latency probes (PICO_ALTIMETER_PROBES builds): GPIO 6 to 10, one for each
+// probe::Stage
+constexpr uint PIN_GPIO_PROBE_BASE = 6;
+
+void initializePins();
+
+// Free an I2C bus held low by a device stuck mid-transfer: clock SCL until the
+// device lets go of SDA, send a STOP, then reset the controller and hand the
+// pins back to it. Returns true if SDA is high afterwards.
+bool recoverI2cBus(i2c_inst_t* i2c, uint sdaPin, uint sclPin);
@@ -0,0 +1,72 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "pipeline.h"
+#include <cmath>
+
+namespace pipeline {
+
+constexpr double STANDARD_PRESSURE_PA = 101325.0;
+constexpr double FEET_PER_METER = 3.28084;
+
+double altitudeFeet(double pressurePa, double seaLevelPa) {
+    // altitude = 44330 * (1 - (P/P0)^(1/5.255))
+    if (pressurePa <= 0 || seaLevelPa <= 0) {
+        return 0.0;
+    }
+    return 44330.0 * (1.0 - pow(pressurePa / seaLevelPa, 0.1903)) * FEET_PER_METER;
+}
+
+Pipeline::Pipeline()
+    : seaLevelPressurePa(STANDARD_PRESSURE_PA), estimating(true), rejectingOutliers(true), estimatedUs(UINT64_MAX),
+      filteredUs(UINT64_MAX), filteredPa(STANDARD_PRESSURE_PA), output(), published(output) {
+}
+
+Output Pipeline::step(sampling::Source& source, uint32_t timeMs) {
+    bool valid = source.readSensor();
+    return process(timeMs, valid, source.getPressure(), source.getTemperature(), source.getSampleTimeUs());
+}
+
+Output Pipeline::process(uint32_t timeMs, bool valid, double pressurePa, double temperatureC, uint64_t sampleTimeUs) {
+    output.timeMs = timeMs;
+    output.valid = valid;
+    output.flightEvent = flightevents::Event::None;
+    output.outlier = false;
+    if (valid) {
+        output.sampleTimeUs = sampleTimeUs;
+        output.pressurePa = pressurePa;
+        output.temperatureC = temperatureC;
+
+        // Spikes are replaced before they reach the estimates (the window
+        // is kept up to date with estimation off, ready for when it is on).
+        // The window holds samples, not reads: a read that found no new
+        // conversion gets what the filter made of that sample.
+        if (!rejectingOutliers) {
+            filteredPa = pressurePa;
+            filteredUs = UINT64_MAX;
+        } else if (sampleTimeUs != filteredUs) {
+            filteredUs = sampleTimeUs;
+            filteredPa = outliers.filter(pressurePa);
+            output.outlier = outliers.wasOutlier();
+        }
+        if (estimating) {
+            output.altitudeFeet = altitudeFeet(filteredPa, seaLevelPressurePa.load());
+            output.displayFeet = static_cast<int>(output.altitudeFeet);
+
+            // Vertical speed and flight events follow pressure altitude, as a
+            // VSI's capsule does, so changing the altimeter setting is not a
+            // climb. A read that found no new conversion repeats the last
+            // sample's time; they have seen it already.
+            if (sampleTimeUs != estimatedUs) {
+                estimatedUs = sampleTimeUs;
+                double pressureAltitude = altitudeFeet(filteredPa, STANDARD_PRESSURE_PA);
+                output.verticalFeetPerMinute = vertical.update(sampleTimeUs, pressureAltitude);
+                output.displayFeetPerMinute = static_cast<int>(lround(output.verticalFeetPerMinute / 10.0)) * 10;
+                output.flightEvent = detector.update(sampleTimeUs, pressureAltitude);
+            }
+        }
+    }
+    published.store(output);
+    return output;
+}
+
+}  // namespace pipeline
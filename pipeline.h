@@ -0,0 +1,82 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+#include "flightevents.h"
+#include "outlier.h"
+#include "sampling.h"
+#include "seqlock.h"
+#include "verticalspeed.h"
+
+// Altitude pipeline: turns samples from a sampling::Source into the values
+// shown on the display. It has no SDK dependencies so recorded flights can
+// be replayed through it on the host.
+namespace pipeline {
+
+struct Output {
+    uint32_t timeMs;
+    uint64_t sampleTimeUs;   // When the sample was taken, from the source (MCU clock)
+    bool valid;              // False if the read failed; values repeat the last good sample
+    bool outlier;            // Pressure rejected as a spike; the estimates used the window median
+    double pressurePa;       // As measured, outlier or not
+    double temperatureC;
+    double altitudeFeet;
+    int displayFeet;         // Value sent to the display
+    double verticalFeetPerMinute;
+    int displayFeetPerMinute; // Vertical speed as shown, to the nearest 10
+    flightevents::Event flightEvent;   // Detected at this sample (usually None)
+};
+
+// International barometric formula, in feet
+double altitudeFeet(double pressurePa, double seaLevelPa);
+
+class Pipeline {
+public:
+    Pipeline();
+
+    // Reference sea level pressure in Pascals (safe from either core)
+    void setSeaLevelPressure(double pascals) { seaLevelPressurePa.store(pascals); }
+    double getSeaLevelPressure() const { return seaLevelPressurePa.load(); }
+
+    // With estimation off, samples are still taken and published but the
+    // altitude and vertical speed are not worked out and hold their last
+    // values, and flight events are not looked for (for modes that do not
+    // show them). On by default.
+    void setEstimating(bool on) { estimating = on; }
+    bool isEstimating() const { return estimating; }
+
+    // With rejection off, samples reach the estimates as measured, spikes
+    // and all (for measuring what the outlier filter costs). On by default.
+    void setRejectingOutliers(bool on) { rejectingOutliers = on; }
+
+    // Acquire one sample from source at timeMs and compute the outputs
+    Output step(sampling::Source& source, uint32_t timeMs);
+
+    // Compute the outputs for a sample acquired elsewhere (valid is false
+    // if the read failed, and the values are then ignored)
+    Output process(uint32_t timeMs, bool valid, double pressurePa, double temperatureC, uint64_t sampleTimeUs);
+
+    // Samples rejected as outliers since start (stepping context only)
+    uint32_t getOutlierCount() const { return outliers.getRejectedCount(); }
+
+    // Details of the last flight event (stepping context only)
+    const flightevents::Detection& getLastDetection() const { return detector.getLastDetection(); }
+
+    // Outputs of the last step, as a consistent copy (safe from either core)
+    Output getOutput() const { return published.load(); }
+
+private:
+    seqlock::SeqLock<double> seaLevelPressurePa;
+    bool estimating;
+    bool rejectingOutliers;
+    uint64_t estimatedUs;                   // Sample time the estimates last took
+    uint64_t filteredUs;                    // Sample time the outlier filter last took
+    double filteredPa;                      // What it made of that sample
+    outlier::Hampel outliers;
+    verticalspeed::Estimator vertical;
+    flightevents::Detector detector;
+    Output output;                          // Working copy, owned by the stepping context
+    seqlock::SeqLock<Output> published;
+};
+
+}  // namespace pipeline
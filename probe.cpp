@@ -0,0 +1,28 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "probe.h"
+
+#if PICO_ALTIMETER_PROBES
+
+#include "pico/stdlib.h"
+#include "pins.h"
+
+namespace probe {
+
+constexpr uint32_t PROBE_MASK = ((1u << static_cast<uint32_t>(Stage::Count)) - 1) << PIN_GPIO_PROBE_BASE;
+
+void init() {
+    gpio_init_mask(PROBE_MASK);
+    gpio_set_dir_out_masked(PROBE_MASK);
+    gpio_clr_mask(PROBE_MASK);
+}
+
+// A toggle rather than a pulse: one register write, safe from interrupts,
+// and every edge is a mark
+void mark(Stage stage) {
+    gpio_xor_mask(1u << (PIN_GPIO_PROBE_BASE + static_cast<uint32_t>(stage)));
+}
+
+}  // namespace probe
+
+#endif  // PICO_ALTIMETER_PROBES
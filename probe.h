@@ -0,0 +1,32 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+// Latency probe marks on a sample's way to the display. In a
+// PICO_ALTIMETER_PROBES build each stage toggles its own GPIO
+// (PIN_GPIO_PROBE_BASE + stage), so a logic analyser on those pins, the
+// sensor's INT pin (data ready, for the conversion) and the display bus times
+// every stage of the real thing. The host latency harness supplies its own
+// mark() and timestamps the same points in simulated time. In other builds
+// the marks compile to nothing.
+namespace probe {
+
+enum class Stage : uint8_t {
+    Read,           // Sensor burst read finished
+    Compensate,     // Sample compensated
+    Estimate,       // Pipeline outputs worked out
+    Render,         // Frame drawn and handed to the bus
+    Flush,          // Frame on the display
+    Count
+};
+
+#if PICO_ALTIMETER_PROBES
+void init();
+void mark(Stage stage);
+#else
+inline void init() {}
+inline void mark(Stage) {}
+#endif
+
+}  // namespace probe
@@ -0,0 +1,115 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "render.h"
+#include "probe.h"
+#include "task.h"
+#include "pico/stdlib.h"
+
+namespace render {
+
+static DrawFn drawFrame = nullptr;
+static bool running = false;
+static task::Completion frameRequested;
+
+// Set while the task draws; a frame handed to the bus is awaited
+static bool drawing = false;
+static bool transferBegun = false;
+static task::Completion transferDone;
+
+// Oldest input not yet on the display
+static bool inputPending = false;
+static uint32_t pendingInputUs = 0;
+
+static LatencyStats stats = {};
+static uint64_t latencySumUs = 0;
+
+// Account for the input a frame on the display answers
+static void account(bool hadInput, uint32_t inputUs) {
+    if (hadInput) {
+        uint32_t latencyUs = time_us_32() - inputUs;
+        stats.frames++;
+        stats.lastUs = latencyUs;
+        stats.maxUs = latencyUs > stats.maxUs ? latencyUs : stats.maxUs;
+        latencySumUs += latencyUs;
+        stats.meanUs = static_cast<uint32_t>(latencySumUs / stats.frames);
+    }
+}
+
+// Synchronous frames write the display themselves
+static void draw() {
+    bool hadInput = inputPending;
+    inputPending = false;
+    drawFrame();
+    probe::mark(probe::Stage::Render);
+    probe::mark(probe::Stage::Flush);
+    account(hadInput, pendingInputUs);
+}
+
+static task::Task renderTask() {
+    while (true) {
+        co_await frameRequested;
+        frameRequested.reset();
+
+        bool hadInput = inputPending;
+        uint32_t inputUs = pendingInputUs;
+        inputPending = false;
+        drawing = true;
+        transferBegun = false;
+        drawFrame();
+        drawing = false;
+        probe::mark(probe::Stage::Render);
+        if (transferBegun) {
+            co_await transferDone;
+        }
+        probe::mark(probe::Stage::Flush);
+        account(hadInput, inputUs);
+
+        co_await task::sleepFor(FRAME_INTERVAL_MS);
+    }
+}
+
+bool start(DrawFn draw) {
+    drawFrame = draw;
+    running = task::spawn(renderTask());
+    return running;
+}
+
+void request() {
+    if (!drawFrame) {
+        return;
+    }
+    if (!running) {
+        draw();
+    } else if (frameRequested.isDone()) {
+        stats.coalesced++;
+    } else {
+        frameRequested.signal();
+    }
+}
+
+void requestForInput(uint32_t inputUs) {
+    if (!inputPending) {
+        inputPending = true;
+        pendingInputUs = inputUs;
+    }
+    request();
+}
+
+task::Completion* beginTransfer() {
+    if (!drawing) {
+        return nullptr;
+    }
+    transferBegun = true;
+    return &transferDone;
+}
+
+LatencyStats getStats() {
+    return stats;
+}
+
+void resetStats() {
+    stats = LatencyStats{};
+    latencySumUs = 0;
+}
+
+}  // namespace render
@@ -0,0 +1,51 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+#include "task.h"
+
+// Display frames on demand. Anything that changes what should be shown asks
+// for a frame; a task draws it within a pass of the event loop, but never
+// sooner than FRAME_INTERVAL_MS after the previous one, and requests that
+// arrive in between are folded into one frame. Frames asked for on behalf of
+// an input carry the input's time, and the delay from input to the frame
+// being on the display is recorded.
+namespace render {
+
+// A frame is 18 bytes on the bus, under 2 ms at 100 kHz; 50 frames a second
+// keeps the display to a tenth of a bus the sensors may share and is faster
+// than the eye follows the digits
+constexpr uint32_t FRAME_INTERVAL_MS = 20;
+
+// Puts the current state on the display, with writeDisplay() or by handing
+// the frame to the bus (beginTransfer())
+using DrawFn = void (*)();
+
+struct LatencyStats {
+    uint32_t frames;        // Frames drawn for an input
+    uint32_t coalesced;     // Requests folded into a frame already pending
+    uint32_t lastUs;        // Input to display, last frame
+    uint32_t meanUs;
+    uint32_t maxUs;
+};
+
+// Start the render task. Returns false if it could not start; frames are
+// then drawn synchronously, without rate limiting.
+bool start(DrawFn draw);
+
+// Ask for a frame (the state changed, not in response to an input)
+void request();
+
+// Ask for a frame showing an input that happened at inputUs (time_us_32())
+void requestForInput(uint32_t inputUs);
+
+// For a DrawFn that writes the frame in the background: the completion to
+// signal once it is on the display. The task waits for it before counting the
+// frame as shown or drawing the next. nullptr outside a frame drawn by the
+// task; write synchronously then.
+task::Completion* beginTransfer();
+
+LatencyStats getStats();
+void resetStats();
+
+}  // namespace render
@@ -0,0 +1,159 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "replay.h"
+
+namespace replay {
+
+using logformat::PAGE_SIZE;
+
+ReplaySource::ReplaySource(const uint8_t* log, size_t size, const Options& options)
+    : log(log), pageCount(size / PAGE_SIZE), oldestPage(0), memory(nullptr), memoryCount(0),
+      options(options), empty(true), current(), temperature(0.0), pressure(0.0) {
+    // The log is circular, so walking forward from the oldest page visits
+    // every page in sequence order
+    uint32_t oldestSequence = 0;
+    for (size_t i = 0; i < pageCount; ++i) {
+        const uint8_t* page = log + i * PAGE_SIZE;
+        if (!logformat::isValidPage(page)) {
+            continue;
+        }
+        uint32_t sequence = logformat::getHeader(page)->sequence;
+        if (empty || static_cast<int32_t>(sequence - oldestSequence) < 0) {
+            oldestSequence = sequence;
+            oldestPage = i;
+            empty = false;
+        }
+    }
+    rewind();
+}
+
+ReplaySource::ReplaySource(const logformat::Record* records, size_t count, const Options& options)
+    : log(nullptr), pageCount(0), oldestPage(0), memory(records), memoryCount(count),
+      options(options), empty(count == 0), current(), temperature(0.0), pressure(0.0) {
+    rewind();
+}
+
+void ReplaySource::rewind() {
+    pagesRead = 0;
+    recordIndex = 0;
+    recordCount = 0;
+    pageSession = 0;
+    pageSeaLevel = 0;
+    hasPending = false;
+    anchored = false;
+    exhausted = empty;
+    lastOk = false;
+    samples = 0;
+}
+
+bool ReplaySource::loadPage() {
+    while (pagesRead < pageCount) {
+        const uint8_t* page = log + ((oldestPage + pagesRead) % pageCount) * PAGE_SIZE;
+        pagesRead++;
+        if (!logformat::isValidPage(page)) {
+            continue;
+        }
+        const logformat::PageHeader* header = logformat::getHeader(page);
+        recordCount = logformat::readRecords(page, pageRecords, logformat::PAGE_PAYLOAD_SIZE);
+        recordIndex = 0;
+        pageSession = header->session;
+        pageSeaLevel = header->seaLevelCentiPa;
+        if (recordCount > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReplaySource::next(Item& item) {
+    if (exhausted) {
+        return false;
+    }
+    bool wrapped = false;
+    while (true) {
+        if (memory) {
+            if (recordIndex < memoryCount) {
+                item = {memory[recordIndex++], 0, 0};
+                if (skipped(item.record)) {
+                    continue;
+                }
+                return true;
+            }
+        } else {
+            if (recordIndex < recordCount) {
+                item = {pageRecords[recordIndex++], pageSession, pageSeaLevel};
+                if (skipped(item.record)) {
+                    continue;
+                }
+                return true;
+            }
+            if (loadPage()) {
+                continue;
+            }
+        }
+
+        // Out of samples: stop, or go round again (once, in case nothing decodes)
+        if (!options.loop || wrapped) {
+            exhausted = true;
+            return false;
+        }
+        wrapped = true;
+        pagesRead = 0;
+        recordIndex = 0;
+        recordCount = 0;
+    }
+}
+
+bool ReplaySource::deliver(const Item& item) {
+    current = item;
+    samples++;
+    lastOk = !(item.record.flags & logformat::RECORD_SENSOR_ERROR);
+    if (lastOk) {
+        pressure = item.record.pressureCentiPa / 100.0;
+        temperature = item.record.temperatureCentiC / 100.0;
+    }
+    return lastOk;
+}
+
+bool ReplaySource::readSensor() {
+    if (options.pacing == Pacing::Fast || !options.clock) {
+        Item item;
+        if (!next(item)) {
+            return false;
+        }
+        return deliver(item);
+    }
+
+    uint32_t now = options.clock();
+    if (!hasPending) {
+        hasPending = next(pending);
+        if (!hasPending) {
+            return false;
+        }
+    }
+    if (!anchored) {
+        anchorClockMs = now;
+        anchorRecordMs = pending.record.timeMs;
+        anchored = true;
+    }
+
+    // Take the newest sample that is due
+    Item item;
+    bool due = false;
+    while (hasPending && pending.record.timeMs - anchorRecordMs <= now - anchorClockMs) {
+        item = pending;
+        due = true;
+        hasPending = next(pending);
+        if (hasPending && (pending.session != item.session || pending.record.timeMs < item.record.timeMs)) {
+            // A new flight (or the loop restarting): its clock starts again
+            anchored = false;
+            break;
+        }
+    }
+    if (!due) {
+        return lastOk;
+    }
+    return deliver(item);
+}
+
+}  // namespace replay
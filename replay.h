@@ -0,0 +1,113 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "logformat.h"
+#include "sampling.h"
+
+// Replays recorded flights through the sampling::Source interface, so the
+// pipeline sees exactly what it would have seen from the sensor. Works on a
+// flight log region (the device's own flash, or a dump of it on the host)
+// or on records already in memory.
+namespace replay {
+
+enum class Pacing : uint8_t {
+    RealTime,   // Deliver each sample when its recorded time comes due
+    Fast        // Deliver the next sample on every read
+};
+
+// Millisecond clock used for real-time pacing
+using Clock = uint32_t (*)();
+
+struct Options {
+    Pacing pacing = Pacing::Fast;
+    Clock clock = nullptr;       // Required for Pacing::RealTime
+    bool loop = false;           // Start again after the last sample
+    bool captures = false;       // Include event capture samples (RECORD_CAPTURE), which
+                                 // repeat regular ones out of time order
+};
+
+class ReplaySource : public sampling::Source {
+public:
+    // Replay a flight log region, oldest page first
+    ReplaySource(const uint8_t* log, size_t size, const Options& options = Options());
+
+    // Replay records from memory (session and sea level are reported as 0)
+    ReplaySource(const logformat::Record* records, size_t count, const Options& options = Options());
+
+    // Returns false for a recorded sensor error, or when no sample is left.
+    // In real time, reads between recorded samples repeat the last one and
+    // samples the caller was too slow for are skipped.
+    bool readSensor() override;
+
+    double getTemperature() const override { return temperature; }
+    double getPressure() const override { return pressure; }
+
+    // Recorded time of the last sample; logs keep milliseconds
+    uint64_t getSampleTimeUs() const override { return static_cast<uint64_t>(current.record.timeMs) * 1000; }
+
+    // Recorded time of the last sample (ms since that flight's boot)
+    uint32_t getTimeMs() const { return current.record.timeMs; }
+
+    // Boot session and altimeter setting (Pa, 0 if unknown) of the last sample
+    uint16_t getSession() const { return current.session; }
+    double getSeaLevelPressure() const { return current.seaLevelCentiPa / 100.0; }
+
+    // Samples delivered so far
+    uint32_t getSampleCount() const { return samples; }
+
+    // True once every sample has been delivered (never when looping)
+    bool finished() const { return exhausted && !hasPending; }
+
+    // Start again from the oldest sample
+    void rewind();
+
+private:
+    struct Item {
+        logformat::Record record;
+        uint16_t session;
+        uint32_t seaLevelCentiPa;
+    };
+
+    bool next(Item& item);
+    bool loadPage();
+    bool skipped(const logformat::Record& record) const {
+        return !options.captures && (record.flags & logformat::RECORD_CAPTURE);
+    }
+    bool deliver(const Item& item);
+
+    // Source data: either log pages or a record array
+    const uint8_t* log;
+    size_t pageCount;
+    size_t oldestPage;
+    const logformat::Record* memory;
+    size_t memoryCount;
+    Options options;
+    bool empty;
+
+    // Position: pages walked from the oldest, records decoded from the page
+    size_t pagesRead;
+    size_t recordIndex;
+    size_t recordCount;
+    uint16_t pageSession;
+    uint32_t pageSeaLevel;
+    logformat::Record pageRecords[logformat::PAGE_PAYLOAD_SIZE];
+
+    // Real-time pacing: recorded time pendingMs is due at clock time
+    // anchorClockMs + (pending - anchorRecordMs)
+    Item pending;
+    bool hasPending;
+    bool anchored;
+    uint32_t anchorClockMs;
+    uint32_t anchorRecordMs;
+
+    Item current;
+    bool exhausted;
+    bool lastOk;
+    uint32_t samples;
+    double temperature;
+    double pressure;
+};
+
+}  // namespace replay
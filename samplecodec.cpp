@@ -0,0 +1,172 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "samplecodec.h"
+
+namespace codec {
+
+// Write an unsigned LEB128 varint, returns the bytes written
+static size_t putVarint(uint32_t value, uint8_t* out) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+// Read an unsigned LEB128 varint, returns the bytes consumed or 0 on error
+static size_t getVarint(const uint8_t* in, size_t length, uint32_t& value) {
+    // Most deltas fit in a single byte
+    if (length > 0 && !(in[0] & 0x80)) {
+        value = in[0];
+        return 1;
+    }
+    value = 0;
+    for (size_t i = 0; i < length && i < 5; ++i) {
+        value |= static_cast<uint32_t>(in[i] & 0x7F) << (7 * i);
+        if (!(in[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+Encoder::Encoder(uint16_t keyframeInterval)
+    : keyframeInterval(keyframeInterval ? keyframeInterval : 1), sinceKeyframe(0),
+      previous(), previousTimeDelta(0) {
+    reset();
+}
+
+void Encoder::reset() {
+    sinceKeyframe = keyframeInterval;
+}
+
+size_t Encoder::encode(const logformat::Record& record, uint8_t* out, size_t capacity) {
+    uint8_t buffer[MAX_SAMPLE_BYTES];
+    size_t length = 1;
+    uint8_t tag = 0;
+
+    if (sinceKeyframe >= keyframeInterval) {
+        tag = TAG_KEYFRAME | TAG_TIME | TAG_PRESSURE | TAG_TEMPERATURE | TAG_FLAGS;
+        length += putVarint(record.timeMs, buffer + length);
+        length += putVarint(zigzag(record.pressureCentiPa), buffer + length);
+        length += putVarint(zigzag(record.temperatureCentiC), buffer + length);
+        length += putVarint(record.flags, buffer + length);
+    } else {
+        int32_t timeDelta = static_cast<int32_t>(record.timeMs - previous.timeMs);
+        int32_t timeDod = timeDelta - previousTimeDelta;
+        int32_t pressureDelta = record.pressureCentiPa - previous.pressureCentiPa;
+        int32_t temperatureDelta = record.temperatureCentiC - previous.temperatureCentiC;
+
+        if (timeDod != 0) {
+            tag |= TAG_TIME;
+            length += putVarint(zigzag(timeDod), buffer + length);
+        }
+        if (pressureDelta != 0) {
+            tag |= TAG_PRESSURE;
+            length += putVarint(zigzag(pressureDelta), buffer + length);
+        }
+        if (temperatureDelta != 0) {
+            tag |= TAG_TEMPERATURE;
+            length += putVarint(zigzag(temperatureDelta), buffer + length);
+        }
+        if (record.flags != previous.flags) {
+            tag |= TAG_FLAGS;
+            length += putVarint(record.flags, buffer + length);
+        }
+    }
+    buffer[0] = tag;
+
+    if (length > capacity) {
+        return 0;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        out[i] = buffer[i];
+    }
+
+    // After a keyframe the predicted spacing is zero, so the first delta
+    // sample carries its whole time delta
+    previousTimeDelta = (tag & TAG_KEYFRAME) ? 0 : static_cast<int32_t>(record.timeMs - previous.timeMs);
+    previous = record;
+    sinceKeyframe = (tag & TAG_KEYFRAME) ? 1 : sinceKeyframe + 1;
+    return length;
+}
+
+Decoder::Decoder() : synced(false), previous(), previousTimeDelta(0) {
+}
+
+void Decoder::reset() {
+    synced = false;
+    previousTimeDelta = 0;
+}
+
+size_t Decoder::decode(const uint8_t* in, size_t length, logformat::Record& record) {
+    if (length == 0) {
+        return 0;
+    }
+
+    uint8_t tag = in[0];
+    size_t used = 1;
+    uint32_t value = 0;
+    size_t n;
+
+    if (tag & TAG_KEYFRAME) {
+        if ((n = getVarint(in + used, length - used, value)) == 0) return 0;
+        used += n;
+        record.timeMs = value;
+        if ((n = getVarint(in + used, length - used, value)) == 0) return 0;
+        used += n;
+        record.pressureCentiPa = unzigzag(value);
+        if ((n = getVarint(in + used, length - used, value)) == 0) return 0;
+        used += n;
+        record.temperatureCentiC = static_cast<int16_t>(unzigzag(value));
+        if ((n = getVarint(in + used, length - used, value)) == 0) return 0;
+        used += n;
+        record.flags = static_cast<uint16_t>(value);
+        previousTimeDelta = 0;
+        synced = true;
+    } else {
+        if (!synced) {
+            return 0;
+        }
+
+        int32_t timeDod = 0;
+        int32_t pressureDelta = 0;
+        int32_t temperatureDelta = 0;
+        uint16_t flags = previous.flags;
+
+        if (tag & TAG_TIME) {
+            if ((n = getVarint(in + used, length - used, value)) == 0) return 0;
+            used += n;
+            timeDod = unzigzag(value);
+        }
+        if (tag & TAG_PRESSURE) {
+            if ((n = getVarint(in + used, length - used, value)) == 0) return 0;
+            used += n;
+            pressureDelta = unzigzag(value);
+        }
+        if (tag & TAG_TEMPERATURE) {
+            if ((n = getVarint(in + used, length - used, value)) == 0) return 0;
+            used += n;
+            temperatureDelta = unzigzag(value);
+        }
+        if (tag & TAG_FLAGS) {
+            if ((n = getVarint(in + used, length - used, value)) == 0) return 0;
+            used += n;
+            flags = static_cast<uint16_t>(value);
+        }
+
+        int32_t timeDelta = previousTimeDelta + timeDod;
+        record.timeMs = previous.timeMs + static_cast<uint32_t>(timeDelta);
+        record.pressureCentiPa = previous.pressureCentiPa + pressureDelta;
+        record.temperatureCentiC = static_cast<int16_t>(previous.temperatureCentiC + temperatureDelta);
+        record.flags = flags;
+        previousTimeDelta = timeDelta;
+    }
+
+    previous = record;
+    return used;
+}
+
+}  // namespace codec
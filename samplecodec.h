@@ -0,0 +1,72 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "logformat.h"
+
+// Streaming compression for altitude samples, used by the flight log and
+// telemetry. Each sample starts with a tag byte. Keyframes hold absolute
+// values; other samples hold the delta-of-delta of the timestamp (on the
+// sensor's clock, so steady sampling costs nothing) and the deltas of
+// pressure and temperature from the previous sample, as zigzag
+// varints. Fields that are zero are omitted and flagged in the tag.
+// Keyframes are emitted periodically so decoding can start there.
+namespace codec {
+
+// Tag byte bits
+constexpr uint8_t TAG_KEYFRAME = 0x80;
+constexpr uint8_t TAG_TIME = 0x01;         // Time delta-of-delta follows
+constexpr uint8_t TAG_PRESSURE = 0x02;     // Pressure delta follows
+constexpr uint8_t TAG_TEMPERATURE = 0x04;  // Temperature delta follows
+constexpr uint8_t TAG_FLAGS = 0x08;        // New flags value follows
+
+// Worst-case encoded size of one sample
+constexpr size_t MAX_SAMPLE_BYTES = 1 + 5 + 5 + 5 + 3;
+
+constexpr uint16_t DEFAULT_KEYFRAME_INTERVAL = 64;
+
+// Zigzag maps signed values to unsigned so small magnitudes stay small
+inline uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+class Encoder {
+public:
+    explicit Encoder(uint16_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    // Make the next sample a keyframe (e.g. at the start of a flash page)
+    void reset();
+
+    // Encode one sample, returns the bytes written or 0 if it did not fit
+    size_t encode(const logformat::Record& record, uint8_t* out, size_t capacity);
+
+private:
+    uint16_t keyframeInterval;
+    uint16_t sinceKeyframe;
+    logformat::Record previous;
+    int32_t previousTimeDelta;
+};
+
+class Decoder {
+public:
+    Decoder();
+
+    // Forget the stream state; the next sample must be a keyframe
+    void reset();
+
+    // Decode one sample, returns the bytes consumed or 0 on truncated or
+    // invalid input (including a delta sample with no keyframe before it)
+    size_t decode(const uint8_t* in, size_t length, logformat::Record& record);
+
+private:
+    bool synced;
+    logformat::Record previous;
+    int32_t previousTimeDelta;
+};
+
+}  // namespace codec
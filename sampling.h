@@ -0,0 +1,28 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+// Acquisition interface between whatever produces pressure samples (the
+// BMP390, or a recorded flight being replayed) and the altitude pipeline.
+namespace sampling {
+
+class Source {
+public:
+    virtual ~Source() = default;
+
+    // Acquire the next sample, returns false if it could not be read
+    virtual bool readSensor() = 0;
+
+    // Last sample read: temperature in degrees Celsius, pressure in Pascals
+    virtual double getTemperature() const = 0;
+    virtual double getPressure() const = 0;
+
+    // When the last sample was taken, in microseconds on the MCU clock (since
+    // boot). Sources that timestamp on the sensor report when its conversion
+    // finished, not when the read happened to run. A read that found no new
+    // conversion repeats the last sample's time.
+    virtual uint64_t getSampleTimeUs() const = 0;
+};
+
+}  // namespace sampling
@@ -0,0 +1,197 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "sensorarray.h"
+#include <cmath>
+
+namespace sensorarray {
+
+constexpr uint PROBE_TIMEOUT_US = 2000;
+
+// Each sensor converts once a period at its own phase, so samples are dated
+// up to a period apart. One further behind the newest than its sensor's
+// period plus this missed a conversion and is dropped.
+constexpr uint64_t ALIGN_WINDOW_US = 20000;
+
+// A sample this far from the median of the others is an outlier. Sensor
+// noise is a few Pa; a glitch or a sensor in a gust is far more.
+constexpr double OUTLIER_PA = 30.0;
+
+// How quickly each sensor's offset from the others is learned, per sample.
+// Slow, and each step is clipped, so a glitch hardly moves it.
+constexpr double BIAS_GAIN = 0.01;
+
+bool probe(i2c_inst_t* i2c, uint8_t address) {
+    uint8_t reg = BMP3_REG_CHIP_ID;
+    uint8_t id = 0;
+    if (i2c_write_timeout_us(i2c, address, &reg, 1, true, PROBE_TIMEOUT_US) < 0 ||
+        i2c_read_timeout_us(i2c, address, &id, 1, false, PROBE_TIMEOUT_US) < 0) {
+        return false;
+    }
+    return id == BMP390_CHIP_ID || id == BMP3_CHIP_ID;
+}
+
+// Median of a small array (sorted in place)
+static double median(double* values, size_t n) {
+    for (size_t i = 1; i < n; ++i) {
+        double value = values[i];
+        size_t j = i;
+        for (; j > 0 && values[j - 1] > value; --j) {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+    return (n & 1) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+SensorArray::SensorArray()
+    : members(), count(0), order(), fusedCount(0), lead(nullptr), lastPressure(0.0), fused(bmp390::Reading{0.0, 0.0, 0}) {
+}
+
+bool SensorArray::add(supervisor::Supervisor& sensor, uint8_t bus) {
+    if (count >= MAX_SENSORS || bus > 1) {
+        return false;
+    }
+    members[count++] = Member{&sensor, bus, 0.0, 0};
+    buildReadOrder();
+    return true;
+}
+
+// Alternate between the controllers so that back-to-back reads are on
+// different buses and every sensor's sample is taken as close as possible to
+// the others
+void SensorArray::buildReadOrder() {
+    size_t next = 0;
+    size_t taken[2] = {0, 0};
+    while (next < count) {
+        for (uint8_t bus = 0; bus < 2; ++bus) {
+            size_t seen = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (members[i].bus != bus) {
+                    continue;
+                }
+                if (seen++ == taken[bus]) {
+                    order[next++] = i;
+                    taken[bus]++;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+bool SensorArray::readSensor() {
+    Sample samples[MAX_SENSORS];
+    size_t taken = 0;
+    lead = nullptr;
+    for (size_t k = 0; k < count; ++k) {
+        size_t index = order[k];
+        Member& member = members[index];
+        if (!member.sensor->readSensor()) {
+            continue;
+        }
+        lead = lead ? lead : member.sensor;
+        samples[taken++] = Sample{index, member.sensor->getSampleTimeUs(),
+                                  member.sensor->getPressure() - member.bias,
+                                  member.sensor->getTemperature()};
+    }
+    if (taken == 0) {
+        return false;
+    }
+
+    // Align: drop samples that fell too far behind the newest one
+    uint64_t newestUs = 0;
+    for (size_t i = 0; i < taken; ++i) {
+        newestUs = samples[i].timeUs > newestUs ? samples[i].timeUs : newestUs;
+    }
+    size_t aligned = 0;
+    for (size_t i = 0; i < taken; ++i) {
+        const bmp390::BMP390& sensor = members[samples[i].member].sensor->getSensor();
+        if (newestUs - samples[i].timeUs <= bmp390::outputPeriodUs(sensor.getProfile()) + ALIGN_WINDOW_US) {
+            samples[aligned++] = samples[i];
+        } else {
+            members[samples[i].member].rejected++;
+        }
+    }
+
+    // Reject outliers against the median. Two sensors that disagree cannot
+    // outvote each other, so keep the one nearer the last fused value.
+    double pressures[MAX_SENSORS];
+    for (size_t i = 0; i < aligned; ++i) {
+        pressures[i] = samples[i].pressure;
+    }
+    double center = median(pressures, aligned);
+    bool accepted[MAX_SENSORS];
+    for (size_t i = 0; i < aligned; ++i) {
+        accepted[i] = aligned < 3 || fabs(samples[i].pressure - center) <= OUTLIER_PA;
+    }
+    if (aligned == 2 && lastPressure > 0 && fabs(samples[0].pressure - samples[1].pressure) > 2 * OUTLIER_PA) {
+        size_t farther = fabs(samples[0].pressure - lastPressure) > fabs(samples[1].pressure - lastPressure) ? 0 : 1;
+        accepted[farther] = false;
+    }
+
+    // Learn each sensor's offset from the consensus
+    if (aligned >= 2) {
+        for (size_t i = 0; i < aligned; ++i) {
+            double residual = samples[i].pressure - center;
+            residual = residual > OUTLIER_PA ? OUTLIER_PA : (residual < -OUTLIER_PA ? -OUTLIER_PA : residual);
+            members[samples[i].member].bias += BIAS_GAIN * residual;
+        }
+    }
+
+    double pressureSum = 0.0;
+    double temperatureSum = 0.0;
+    uint64_t timeSumUs = 0;
+    size_t used = 0;
+    for (size_t i = 0; i < aligned; ++i) {
+        if (!accepted[i]) {
+            members[samples[i].member].rejected++;
+            continue;
+        }
+        pressureSum += samples[i].pressure;
+        temperatureSum += samples[i].temperature;
+        timeSumUs += samples[i].timeUs;
+        used++;
+    }
+
+    // An even count can reject everything when the middle pair disagrees
+    if (used == 0) {
+        pressureSum = center;
+        temperatureSum = samples[0].temperature;
+        timeSumUs = samples[0].timeUs;
+        used = 1;
+    }
+
+    fusedCount = used;
+    lastPressure = pressureSum / used;
+    fused.store(bmp390::Reading{lastPressure, temperatureSum / used, timeSumUs / used});
+    return true;
+}
+
+bool SensorArray::service() {
+    bool busy = false;
+    for (size_t i = 0; i < count; ++i) {
+        busy |= members[i].sensor->service();
+    }
+    return busy;
+}
+
+bool SensorArray::isAvailable() const {
+    for (size_t i = 0; i < count; ++i) {
+        if (members[i].sensor->getHealth() != supervisor::Health::Recovering) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t SensorArray::getRejectedCount(size_t index) const {
+    return index < count ? members[index].rejected : 0;
+}
+
+double SensorArray::getBias(size_t index) const {
+    return index < count ? members[index].bias : 0.0;
+}
+
+}  // namespace sensorarray
@@ -0,0 +1,93 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "bmp390.h"
+#include "sampling.h"
+#include "seqlock.h"
+#include "supervisor.h"
+
+typedef struct i2c_inst i2c_inst_t;
+
+// Several BMP390s read as one sample source. Each read takes one sample from
+// every sensor, alternating between the two I2C controllers, drops samples
+// whose conversions lag the newest by more than a period or that disagree
+// with the rest, and averages what is left.
+// Independent noise falls by about the square root of the sensor count.
+namespace sensorarray {
+
+// Two addresses (0x76, 0x77) on each of the two buses
+constexpr size_t MAX_SENSORS = 4;
+
+// True if a BMP390 (or BMP388) answers at the address
+bool probe(i2c_inst_t* i2c, uint8_t address);
+
+class SensorArray : public sampling::Source {
+public:
+    SensorArray();
+
+    // Add a supervised sensor on I2C controller 0 or 1. Returns false when
+    // the array is full or the bus is not 0 or 1.
+    bool add(supervisor::Supervisor& sensor, uint8_t bus);
+
+    size_t getCount() const { return count; }
+
+    // Read every available sensor and publish the fused sample. Returns false
+    // if no sensor produced a usable sample.
+    bool readSensor() override;
+
+    double getTemperature() const override { return fused.load().temperature; }
+    double getPressure() const override { return fused.load().pressure; }
+
+    // Mean sample time of the sensors that were fused
+    uint64_t getSampleTimeUs() const override { return fused.load().timeUs; }
+
+    // Run the sensors' recovery. Call from the idle loop. Returns true if any
+    // did bus work.
+    bool service();
+
+    // True if at least one sensor is on the bus (not recovering)
+    bool isAvailable() const;
+
+    // Sensors that contributed to the last fused sample
+    size_t getFusedCount() const { return fusedCount; }
+
+    // The first sensor in read order that was read last time (nullptr if
+    // none was), whose conversions the reads can be timed to
+    const supervisor::Supervisor* getLead() const { return lead; }
+
+    // Samples from a sensor rejected as outliers or late
+    uint32_t getRejectedCount(size_t index) const;
+
+    // A sensor's learned pressure offset from the others, Pa
+    double getBias(size_t index) const;
+
+private:
+    struct Member {
+        supervisor::Supervisor* sensor;
+        uint8_t bus;
+        double bias;
+        uint32_t rejected;
+    };
+
+    // One sample taken during the current read
+    struct Sample {
+        size_t member;
+        uint64_t timeUs;    // Conversion time on the MCU clock
+        double pressure;    // Bias corrected
+        double temperature;
+    };
+
+    void buildReadOrder();
+
+    Member members[MAX_SENSORS];
+    size_t count;
+    size_t order[MAX_SENSORS];      // Member indices, alternating buses
+    size_t fusedCount;
+    const supervisor::Supervisor* lead;
+    double lastPressure;            // Last fused pressure (0 before the first)
+    seqlock::SeqLock<bmp390::Reading> fused;
+};
+
+}  // namespace sensorarray
@@ -0,0 +1,65 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+extern "C" {
+#include "bmp3_defs.h"
+}
+
+// BMP390 acquisition settings resolved at compile time. A SensorConfig names
+// oversampling, output data rate and IIR filter with the driver's BMP3_*
+// codes; the register values, the measurement time and the OSR/ODR check
+// that bmp3_set_sensor_settings() would work out at boot are all constants,
+// and a combination the sensor would reject does not compile.
+namespace sensorconfig {
+
+// Register values and timing for one configuration
+struct RegisterImage {
+    uint8_t osr;            // BMP3_REG_OSR
+    uint8_t odr;            // BMP3_REG_ODR
+    uint8_t config;         // BMP3_REG_CONFIG
+    uint8_t pwrCtrl;        // BMP3_REG_PWR_CTRL, both sensors on, normal mode
+    uint32_t measurementUs; // Time for one pressure and temperature conversion
+    uint32_t periodUs;      // Output data period
+};
+
+// Registers written by one burst, in order. The power control register goes
+// last so normal mode starts with the other settings in place.
+constexpr uint8_t BURST_REGISTERS[] = {BMP3_REG_OSR, BMP3_REG_ODR, BMP3_REG_CONFIG, BMP3_REG_PWR_CTRL};
+constexpr uint32_t BURST_LENGTH = sizeof(BURST_REGISTERS);
+
+// Conversion time with both sensors enabled (datasheet section 3.9.2)
+constexpr uint32_t measurementTimeUs(uint8_t pressOs, uint8_t tempOs) {
+    return 234 + (BMP3_SETTLE_TIME_PRESS + (1u << pressOs) * BMP3_ADC_CONV_TIME) +
+           (BMP3_SETTLE_TIME_TEMP + (1u << tempOs) * BMP3_ADC_CONV_TIME);
+}
+
+// Output data period: 5 ms at 200 Hz, doubling with each step of the code
+constexpr uint32_t odrPeriodUs(uint8_t odr) {
+    return 5000u << odr;
+}
+
+template <uint8_t PressOs, uint8_t TempOs, uint8_t Odr, uint8_t IirFilter>
+struct SensorConfig {
+    static_assert(PressOs <= BMP3_OVERSAMPLING_32X, "invalid pressure oversampling");
+    static_assert(TempOs <= BMP3_OVERSAMPLING_32X, "invalid temperature oversampling");
+    static_assert(Odr <= BMP3_ODR_0_001_HZ, "invalid output data rate");
+    static_assert(IirFilter <= BMP3_IIR_FILTER_COEFF_127, "invalid IIR filter coefficient");
+
+    static constexpr uint32_t MEASUREMENT_US = measurementTimeUs(PressOs, TempOs);
+    static constexpr uint32_t PERIOD_US = odrPeriodUs(Odr);
+    static_assert(MEASUREMENT_US < PERIOD_US,
+                  "oversampling takes longer than the output data period (the sensor would set ERR_CONF)");
+
+    static constexpr RegisterImage IMAGE = {
+        static_cast<uint8_t>(PressOs | (TempOs << BMP3_TEMP_OS_POS)),
+        Odr,
+        static_cast<uint8_t>(IirFilter << BMP3_IIR_FILTER_POS),
+        static_cast<uint8_t>(BMP3_ENABLE | (BMP3_ENABLE << BMP3_TEMP_EN_POS) | (BMP3_MODE_NORMAL << BMP3_OP_MODE_POS)),
+        MEASUREMENT_US,
+        PERIOD_US,
+    };
+};
+
+}  // namespace sensorconfig
@@ -0,0 +1,105 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "sensortime.h"
+#include <cmath>
+
+namespace sensortime {
+
+constexpr uint64_t COUNTER_PERIOD = static_cast<uint64_t>(COUNTER_MASK) + 1;
+
+// Loop gains per observation. The MCU side of each observation jitters by the
+// transfer time, so the offset follows slowly and the rate slower still.
+constexpr double OFFSET_GAIN = 0.05;
+constexpr double RATE_GAIN = 0.002;
+
+// Until this many observations have been seen the rate is the straight slope
+// from the first one, which settles a rate error of a few percent at once
+// (the loop alone would take minutes)
+constexpr uint32_t SETTLE_COUNT = 64;
+
+// Shortest baseline the straight slope is trusted over: one second
+constexpr uint64_t MIN_BASELINE_TICKS = TICKS_PER_SECOND;
+
+// The sensor oscillator is trimmed to a few percent; a rate estimate outside
+// this is noise
+constexpr double MAX_RATE_ERROR = 0.05;
+
+// A prediction this far off means the sensor time jumped (a reset, or a
+// stall): start the map again from this observation
+constexpr double RESYNC_US = 20000.0;
+
+Clock::Clock() {
+    reset();
+}
+
+void Clock::reset() {
+    lastCounter = 0;
+    lastTicks = 0;
+    lastMcuUs = 0;
+    firstTicks = 0;
+    firstMcuUs = 0;
+    anchorTicks = 0;
+    anchorUs = 0.0;
+    usPerTick = NOMINAL_US_PER_TICK;
+    count = 0;
+}
+
+uint64_t Clock::update(uint32_t counter, uint64_t mcuUs) {
+    counter &= COUNTER_MASK;
+    if (count == 0) {
+        lastCounter = counter;
+        lastTicks = counter;
+        lastMcuUs = mcuUs;
+        firstTicks = counter;
+        firstMcuUs = mcuUs;
+        anchorTicks = counter;
+        anchorUs = static_cast<double>(mcuUs);
+        count = 1;
+        return lastTicks;
+    }
+
+    // Ticks since the last observation, plus however many whole wraps the
+    // MCU clock says went by
+    uint64_t delta = (counter - lastCounter) & COUNTER_MASK;
+    double elapsedTicks = mcuUs > lastMcuUs ? static_cast<double>(mcuUs - lastMcuUs) / usPerTick : 0.0;
+    double wraps = std::round((elapsedTicks - static_cast<double>(delta)) / COUNTER_PERIOD);
+    uint64_t ticks = lastTicks + delta + (wraps > 0 ? static_cast<uint64_t>(wraps) * COUNTER_PERIOD : 0);
+
+    double low = NOMINAL_US_PER_TICK * (1.0 - MAX_RATE_ERROR);
+    double high = NOMINAL_US_PER_TICK * (1.0 + MAX_RATE_ERROR);
+    if (count < SETTLE_COUNT && ticks - firstTicks >= MIN_BASELINE_TICKS && mcuUs > firstMcuUs) {
+        usPerTick = static_cast<double>(mcuUs - firstMcuUs) / static_cast<double>(ticks - firstTicks);
+        usPerTick = usPerTick < low ? low : (usPerTick > high ? high : usPerTick);
+    }
+
+    double predictedUs = anchorUs + static_cast<double>(ticks - anchorTicks) * usPerTick;
+    double errorUs = static_cast<double>(mcuUs) - predictedUs;
+    if (std::fabs(errorUs) > RESYNC_US) {
+        anchorUs = static_cast<double>(mcuUs);
+    } else if (count < SETTLE_COUNT) {
+        // Average the offset over the observations so far
+        anchorUs = predictedUs + errorUs / (count + 1);
+    } else {
+        anchorUs = predictedUs + OFFSET_GAIN * errorUs;
+        if (ticks > lastTicks) {
+            usPerTick += RATE_GAIN * errorUs / static_cast<double>(ticks - lastTicks);
+            usPerTick = usPerTick < low ? low : (usPerTick > high ? high : usPerTick);
+        }
+    }
+    anchorTicks = ticks;
+
+    lastCounter = counter;
+    lastTicks = ticks;
+    lastMcuUs = mcuUs;
+    if (count < UINT32_MAX) {
+        count++;
+    }
+    return ticks;
+}
+
+uint64_t Clock::toMcuUs(uint64_t ticks) const {
+    double us = anchorUs + (static_cast<double>(ticks) - static_cast<double>(anchorTicks)) * usPerTick;
+    return us > 0.0 ? static_cast<uint64_t>(us + 0.5) : 0;
+}
+
+}  // namespace sensortime
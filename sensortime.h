@@ -0,0 +1,56 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+// The BMP390's sensor time: a 24-bit counter at 25.6 kHz that wraps every
+// 655 seconds and runs on the sensor's own oscillator. A Clock unwraps it
+// into a 64-bit tick count and tracks its offset and rate against the MCU
+// clock, so a sample's sensor time converts to MCU microseconds without the
+// jitter of when the loop got round to reading it. No SDK dependencies.
+namespace sensortime {
+
+constexpr uint32_t TICKS_PER_SECOND = 25600;
+constexpr double NOMINAL_US_PER_TICK = 1e6 / TICKS_PER_SECOND;   // 39.0625
+constexpr uint32_t COUNTER_MASK = 0xFFFFFF;
+
+class Clock {
+public:
+    Clock();
+
+    // Forget the history (the sensor was reset or re-initialized)
+    void reset();
+
+    // Add an observation: the raw 24-bit counter and the MCU time (us) it was
+    // read at. Returns the unwrapped tick count. Wraps are resolved against
+    // the MCU time elapsed since the last observation, so reads may be any
+    // distance apart.
+    uint64_t update(uint32_t counter, uint64_t mcuUs);
+
+    // MCU time (us) at an unwrapped tick count
+    uint64_t toMcuUs(uint64_t ticks) const;
+
+    // Ticks of the last observation
+    uint64_t getTicks() const { return lastTicks; }
+
+    // Current estimate of the sensor tick in MCU microseconds
+    double getUsPerTick() const { return usPerTick; }
+
+    // Observations since the last reset
+    uint32_t getCount() const { return count; }
+
+private:
+    uint32_t lastCounter;
+    uint64_t lastTicks;
+    uint64_t lastMcuUs;
+    uint64_t firstTicks;    // First observation, for the initial rate
+    uint64_t firstMcuUs;
+
+    // Linear map from ticks to MCU time through (anchorTicks, anchorUs)
+    uint64_t anchorTicks;
+    double anchorUs;
+    double usPerTick;
+    uint32_t count;
+};
+
+}  // namespace sensortime
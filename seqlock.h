@@ -0,0 +1,82 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Publication of multi-word state from one writer to any number of readers,
+// on either core or in interrupt handlers, without locks. The writer never
+// waits. A reader copies the value and retries if a write overlapped it.
+namespace seqlock {
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied word by word");
+
+public:
+    SeqLock() : sequence(0) {
+        store(T());
+    }
+
+    explicit SeqLock(const T& value) : sequence(0) {
+        store(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Publish a new value. Only one context may write at a time (callers
+    // with several writers must serialize them).
+    void store(const T& value) {
+        uint32_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+
+        // An odd sequence marks a write in progress
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            data[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Read a consistent copy, retrying while a write is in progress. Do not
+    // call from an interrupt that can preempt the writer on the same core
+    // (use tryLoad there).
+    T load() const {
+        T value;
+        while (!tryLoad(value)) {
+        }
+        return value;
+    }
+
+    // Read a consistent copy if no write is in progress, returns false otherwise
+    bool tryLoad(T& value) const {
+        uint32_t words[WORDS];
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        for (size_t i = 0; i < WORDS; ++i) {
+            words[i] = data[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> data[WORDS];
+};
+
+}  // namespace seqlock
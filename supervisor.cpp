@@ -0,0 +1,171 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/watchdog.h"
+#include "supervisor.h"
+#include "i2cbus.h"
+#include "logger.h"
+#include "pins.h"
+
+namespace supervisor {
+
+// Consecutive failed reads before the sensor is re-initialized
+constexpr uint32_t MAX_CONSECUTIVE_FAILURES = 3;
+
+// Consecutive reads with an unchanged sensor time before the sensor is
+// considered frozen (the clock ticks at 25.6 kHz, so one repeat is enough to
+// mark a read stale)
+constexpr uint32_t MAX_STALE_READS = 3;
+
+// Recovery backoff: the first retry comes quickly, then the interval doubles
+constexpr uint32_t INITIAL_BACKOFF_MS = 100;
+constexpr uint32_t MAX_BACKOFF_MS = 4000;
+
+// The RP2350 watchdog counts down from at most 0xFFFFFF microseconds
+constexpr uint32_t WATCHDOG_MAX_MS = 16000;
+
+// Slack on top of the longest expected gap between feeds
+constexpr uint32_t WATCHDOG_MARGIN_MS = 2000;
+
+static bool watchdogEnabled = false;
+
+static uint32_t millisSinceBoot() {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void feedWatchdog() {
+    if (watchdogEnabled) {
+        watchdog_update();
+    }
+}
+
+static const char* faultName(uint8_t fault) {
+    static const char* const NAMES[] = {"not responding", "read failures", "bus stuck", "sensor time frozen"};
+    return fault < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[fault] : "unknown";
+}
+
+Supervisor::Supervisor(bmp390::BMP390& sensor, i2c_inst_t* i2c, uint sdaPin, uint sclPin)
+    : sensor(sensor), i2c(i2c), sdaPin(sdaPin), sclPin(sclPin), profile(bmp390::Profile::Standard),
+      health(Health::Healthy), fault(Fault::NotResponding), consecutiveFailures(0), staleReads(0),
+      lastSensorTime(0), haveSensorTime(false), attempts(0), backoffMs(INITIAL_BACKOFF_MS),
+      nextAttemptMs(0), recoveries(0) {
+}
+
+bool Supervisor::begin(bmp390::Profile requestedProfile) {
+    profile = requestedProfile;
+    if (!sensor.begin(profile)) {
+        startRecovery(sensor.getLastBusError() == PICO_ERROR_TIMEOUT ? Fault::BusStuck : Fault::NotResponding,
+                      millisSinceBoot());
+        return false;
+    }
+    health = Health::Healthy;
+    haveSensorTime = false;
+    return true;
+}
+
+bool Supervisor::readSensor() {
+    if (health == Health::Recovering) {
+        return false;
+    }
+
+    uint32_t nowMs = millisSinceBoot();
+    bool read;
+    {
+        i2cbus::Claim claim(i2c);
+        read = sensor.readSensor();
+    }
+    if (!read) {
+        // A timeout means the bus itself is wedged; every further read would
+        // cost a timeout too, so recover straight away
+        if (sensor.getLastBusError() == PICO_ERROR_TIMEOUT) {
+            startRecovery(Fault::BusStuck, nowMs);
+        } else if (++consecutiveFailures >= MAX_CONSECUTIVE_FAILURES) {
+            startRecovery(Fault::ReadFailures, nowMs);
+        } else {
+            health = Health::Suspect;
+        }
+        return false;
+    }
+    consecutiveFailures = 0;
+
+    // The data registers hold their last value when conversions stop, so a
+    // repeated sensor time means the sample is stale
+    uint32_t sensorTime = sensor.getSensorTime();
+    if (haveSensorTime && sensorTime == lastSensorTime) {
+        if (++staleReads >= MAX_STALE_READS) {
+            startRecovery(Fault::Frozen, nowMs);
+        } else {
+            health = Health::Suspect;
+        }
+        return false;
+    }
+    lastSensorTime = sensorTime;
+    haveSensorTime = true;
+    staleReads = 0;
+
+    health = Health::Healthy;
+    feedWatchdog();
+    return true;
+}
+
+bool Supervisor::service() {
+    if (health != Health::Recovering) {
+        return false;
+    }
+    uint32_t nowMs = millisSinceBoot();
+    if (static_cast<int32_t>(nowMs - nextAttemptMs) < 0) {
+        return false;
+    }
+
+    attempts++;
+    i2cbus::Claim claim(i2c);
+    if (fault == Fault::BusStuck || sensor.getLastBusError() == PICO_ERROR_TIMEOUT) {
+        bool released = recoverI2cBus(i2c, sdaPin, sclPin);
+        logger::log(logger::Msg::I2cBusCleared, released ? "released" : "still held");
+    }
+
+    if (sensor.begin(profile)) {
+        logger::log(logger::Msg::SensorRecovered, i2c_get_index(i2c), sensor.getAddress(), attempts);
+        recoveries++;
+        health = Health::Healthy;
+        consecutiveFailures = 0;
+        staleReads = 0;
+        haveSensorTime = false;
+    } else {
+        backoffMs = backoffMs * 2 < MAX_BACKOFF_MS ? backoffMs * 2 : MAX_BACKOFF_MS;
+        nextAttemptMs = millisSinceBoot() + backoffMs;
+        logger::log(logger::Msg::SensorRetry, i2c_get_index(i2c), sensor.getAddress(), attempts, backoffMs);
+    }
+
+    // A completed attempt is progress: the loop is alive and on schedule
+    feedWatchdog();
+    return true;
+}
+
+void Supervisor::startRecovery(Fault newFault, uint32_t nowMs) {
+    logger::log(logger::Msg::SensorFault, i2c_get_index(i2c), sensor.getAddress(),
+                faultName(static_cast<uint8_t>(newFault)));
+    fault = newFault;
+    health = Health::Recovering;
+    attempts = 0;
+    backoffMs = INITIAL_BACKOFF_MS;
+    nextAttemptMs = nowMs + backoffMs;
+}
+
+void enableWatchdog(uint32_t samplePeriodMs) {
+    if (watchdog_caused_reboot()) {
+        logger::log(logger::Msg::WatchdogReboot);
+    }
+
+    uint32_t longestGap = samplePeriodMs > MAX_BACKOFF_MS ? samplePeriodMs : MAX_BACKOFF_MS;
+    uint32_t timeoutMs = longestGap + WATCHDOG_MARGIN_MS;
+    if (timeoutMs > WATCHDOG_MAX_MS) {
+        timeoutMs = WATCHDOG_MAX_MS;
+    }
+    // Pause while a debugger has the cores halted
+    watchdog_enable(timeoutMs, true);
+    watchdogEnabled = true;
+}
+
+}  // namespace supervisor
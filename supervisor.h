@@ -0,0 +1,83 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+#include "pico/types.h"
+#include "bmp390.h"
+#include "sampling.h"
+
+// Sensor health supervision. The supervisor stands between the pipeline and
+// the BMP390: it watches each read for repeated failures, a stuck bus and a
+// stalled sensor clock, takes the sensor off the bus when one is found and
+// brings it back from the idle loop with exponential backoff, so the display
+// and encoder keep working while the sensor is away. It also owns the
+// hardware watchdog, which is fed only while acquisition makes progress.
+namespace supervisor {
+
+enum class Health : uint8_t {
+    Healthy,      // Reads are succeeding
+    Suspect,      // Recent reads failed or returned stale data
+    Recovering    // Sensor is off the bus, waiting for the next re-init
+};
+
+class Supervisor : public sampling::Source {
+public:
+    Supervisor(bmp390::BMP390& sensor, i2c_inst_t* i2c, uint sdaPin, uint sclPin);
+
+    // Initialize the sensor. On failure the supervisor starts recovering and
+    // keeps trying from service().
+    bool begin(bmp390::Profile profile);
+
+    // Read the sensor unless it is recovering (no bus traffic then). Returns
+    // false for failed and stale reads.
+    bool readSensor() override;
+
+    double getTemperature() const override { return sensor.getTemperature(); }
+    double getPressure() const override { return sensor.getPressure(); }
+    uint64_t getSampleTimeUs() const override { return sensor.getSampleTimeUs(); }
+
+    // Run a recovery attempt when one is due. Call from the idle loop.
+    // Returns true if it did any bus work.
+    bool service();
+
+    Health getHealth() const { return health; }
+
+    const bmp390::BMP390& getSensor() const { return sensor; }
+
+    // Number of times the sensor has been brought back
+    uint32_t getRecoveryCount() const { return recoveries; }
+
+private:
+    enum class Fault : uint8_t {
+        NotResponding,  // begin() failed
+        ReadFailures,   // Too many consecutive failed reads
+        BusStuck,       // A transfer timed out
+        Frozen          // Sensor time stopped advancing
+    };
+
+    void startRecovery(Fault fault, uint32_t nowMs);
+
+    bmp390::BMP390& sensor;
+    i2c_inst_t* i2c;
+    uint sdaPin;
+    uint sclPin;
+    bmp390::Profile profile;
+
+    Health health;
+    Fault fault;
+    uint32_t consecutiveFailures;
+    uint32_t staleReads;
+    uint32_t lastSensorTime;
+    bool haveSensorTime;
+    uint32_t attempts;          // Recovery attempts since the fault
+    uint32_t backoffMs;
+    uint32_t nextAttemptMs;
+    uint32_t recoveries;
+};
+
+// Start the hardware watchdog. Any supervisor's fresh sample or completed
+// recovery attempt feeds it; the timeout allows for the sample period and the
+// longest recovery backoff.
+void enableWatchdog(uint32_t samplePeriodMs);
+
+}  // namespace supervisor
@@ -0,0 +1,232 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "task.h"
+#include "event.h"
+#include "logger.h"
+#include "pico/stdlib.h"
+
+namespace task {
+
+// Frame pool. Each task owns one frame from spawn to completion.
+alignas(8) static uint8_t frames[MAX_TASKS][FRAME_SIZE];
+static bool frameUsed[MAX_TASKS];
+
+// What a suspended task is waiting for
+enum class Wait : uint8_t {
+    None,       // Slot free
+    Ready,      // Spawned or yielded: run on the next pass
+    Time,       // Until deadlineUs
+    Poll,       // Until ready(context), checked at deadlineUs then every pollUs
+    Signal      // Until completion->isDone()
+};
+
+struct Waiter {
+    Wait wait;
+    uint32_t pass;              // run() pass it was added in
+    std::coroutine_handle<> handle;
+    uint64_t deadlineUs;
+    Condition ready;
+    void* context;
+    uint32_t pollUs;
+    const Completion* completion;
+};
+
+// A task waits on one thing at a time, so with one waiter per frame parking
+// cannot fail
+static Waiter waiters[MAX_TASKS];
+static uint32_t pass = 0;
+
+// One alarm for the earliest deadline; it only has to wake the loop
+static volatile alarm_id_t alarmId = 0;
+static uint64_t alarmDeadlineUs = 0;
+
+void* Task::promise_type::operator new(size_t size) noexcept {
+    if (size <= FRAME_SIZE) {
+        for (size_t i = 0; i < MAX_TASKS; ++i) {
+            if (!frameUsed[i]) {
+                frameUsed[i] = true;
+                return frames[i];
+            }
+        }
+    }
+    logger::log(logger::Msg::TaskNoFrame, static_cast<uint32_t>(size), static_cast<uint32_t>(MAX_TASKS),
+                static_cast<uint32_t>(FRAME_SIZE));
+    return nullptr;
+}
+
+void Task::promise_type::operator delete(void* frame) noexcept {
+    for (size_t i = 0; i < MAX_TASKS; ++i) {
+        if (frame == frames[i]) {
+            frameUsed[i] = false;
+            return;
+        }
+    }
+}
+
+Task::~Task() {
+    // Never spawned: nothing else will resume it
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+static int64_t alarmCallback(alarm_id_t, void*) {
+    alarmId = 0;
+    event::queueEventFromISR(event::Event(event::EventType::TaskWake));
+    return 0;
+}
+
+// Park a task; false (carry on without suspending) if no slot is free
+static bool park(const Waiter& waiter) {
+    for (Waiter& slot : waiters) {
+        if (slot.wait == Wait::None) {
+            slot = waiter;
+            slot.pass = pass;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool spawn(Task&& task) {
+    if (!task.valid()) {
+        return false;
+    }
+    Waiter waiter = {};
+    waiter.wait = Wait::Ready;
+    waiter.handle = task.handle;
+    if (!park(waiter)) {
+        return false;
+    }
+    task.handle = nullptr;
+    return true;
+}
+
+static void armAlarm() {
+    uint64_t earliest = UINT64_MAX;
+    for (const Waiter& waiter : waiters) {
+        if ((waiter.wait == Wait::Time || waiter.wait == Wait::Poll) && waiter.deadlineUs < earliest) {
+            earliest = waiter.deadlineUs;
+        }
+    }
+    if (alarmId > 0 && alarmDeadlineUs == earliest) {
+        return;
+    }
+    if (alarmId > 0) {
+        cancel_alarm(alarmId);
+        alarmId = 0;
+    }
+    if (earliest != UINT64_MAX) {
+        alarmDeadlineUs = earliest;
+        alarmId = add_alarm_at(from_us_since_boot(earliest), alarmCallback, nullptr, true);
+    }
+}
+
+bool run() {
+    pass++;
+    bool ran = false;
+    uint64_t nowUs = time_us_64();
+    for (Waiter& waiter : waiters) {
+        // Tasks parked by this pass wait for the next one
+        if (waiter.wait == Wait::None || waiter.pass == pass) {
+            continue;
+        }
+        bool due = false;
+        switch (waiter.wait) {
+            case Wait::Ready:
+                due = true;
+                break;
+            case Wait::Time:
+                due = nowUs >= waiter.deadlineUs;
+                break;
+            case Wait::Poll:
+                if (nowUs >= waiter.deadlineUs) {
+                    due = waiter.ready(waiter.context);
+                    waiter.deadlineUs = nowUs + waiter.pollUs;
+                }
+                break;
+            case Wait::Signal:
+                due = waiter.completion->isDone();
+                break;
+            default:
+                break;
+        }
+        if (due) {
+            std::coroutine_handle<> handle = waiter.handle;
+            waiter.wait = Wait::None;
+            handle.resume();
+            ran = true;
+        }
+    }
+    armAlarm();
+    return ran;
+}
+
+size_t getActiveCount() {
+    size_t count = 0;
+    for (bool used : frameUsed) {
+        count += used ? 1 : 0;
+    }
+    return count;
+}
+
+Sleep sleepFor(uint32_t ms) {
+    return Sleep{time_us_64() + static_cast<uint64_t>(ms) * 1000};
+}
+
+Sleep sleepUntil(uint64_t timeUs) {
+    return Sleep{timeUs};
+}
+
+bool Sleep::await_ready() const noexcept {
+    return time_us_64() >= deadlineUs;
+}
+
+bool Sleep::await_suspend(std::coroutine_handle<> handle) noexcept {
+    Waiter waiter = {};
+    waiter.wait = Wait::Time;
+    waiter.handle = handle;
+    waiter.deadlineUs = deadlineUs;
+    return park(waiter);
+}
+
+Yield yield() {
+    return Yield{};
+}
+
+bool Yield::await_suspend(std::coroutine_handle<> handle) noexcept {
+    Waiter waiter = {};
+    waiter.wait = Wait::Ready;
+    waiter.handle = handle;
+    return park(waiter);
+}
+
+Until until(Condition ready, void* context, uint32_t pollMs) {
+    return Until{ready, context, pollMs * 1000};
+}
+
+bool Until::await_suspend(std::coroutine_handle<> handle) noexcept {
+    Waiter waiter = {};
+    waiter.wait = Wait::Poll;
+    waiter.handle = handle;
+    waiter.deadlineUs = time_us_64() + pollUs;
+    waiter.ready = ready;
+    waiter.context = context;
+    waiter.pollUs = pollUs;
+    return park(waiter);
+}
+
+void Completion::signal() {
+    done = true;
+    event::queueEventFromISR(event::Event(event::EventType::TaskWake));
+}
+
+bool Completion::await_suspend(std::coroutine_handle<> handle) noexcept {
+    Waiter waiter = {};
+    waiter.wait = Wait::Signal;
+    waiter.handle = handle;
+    waiter.completion = this;
+    return park(waiter);
+}
+
+}  // namespace task
@@ -0,0 +1,127 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+// Cooperative tasks on the main loop. A task is a C++20 coroutine that can
+// co_await a timer, a polled condition (a sensor's data ready flag) or a
+// Completion signalled from an interrupt (a transfer finishing). While it
+// waits the loop keeps handling events; run() resumes whatever is due.
+//
+//     task::Task blink(ht16k33::HT16K33& display) {
+//         display.setColon(true);
+//         display.writeDisplay();
+//         co_await task::sleepFor(500);
+//         ...
+//     }
+//     task::spawn(blink(display));
+//
+// Frames come from a fixed pool, never the heap. A coroutine whose frame
+// does not fit cannot be spawned (spawn() returns false and logs it). Tasks
+// run on core 0, from run() only.
+namespace task {
+
+// Tasks alive at once, and the frame each gets. A frame holds the
+// coroutine's locals that live across a co_await plus about 40 bytes.
+constexpr size_t MAX_TASKS = 4;
+constexpr size_t FRAME_SIZE = 256;
+
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        static Task get_return_object_on_allocation_failure() { return Task(nullptr); }
+
+        // Tasks start when spawned and free their frame when they finish
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+
+        static void* operator new(size_t size) noexcept;
+        static void operator delete(void* frame) noexcept;
+    };
+
+    Task(Task&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task& operator=(Task&&) = delete;
+    ~Task();
+
+    // False if the frame could not be allocated
+    bool valid() const { return static_cast<bool>(handle); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    friend bool spawn(Task&& task);
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Hand a task to the executor; it first runs on the next run(). Returns
+// false if the task has no frame or every slot is taken.
+bool spawn(Task&& task);
+
+// Resume every task whose wait is over. Call from the main loop whenever it
+// is idle and on EventType::TaskWake. Returns true if a task ran.
+bool run();
+
+// Tasks created and not yet finished
+size_t getActiveCount();
+
+// co_await sleepFor(ms): resume after ms milliseconds
+struct Sleep {
+    uint64_t deadlineUs;
+    bool await_ready() const noexcept;
+    bool await_suspend(std::coroutine_handle<> handle) noexcept;
+    void await_resume() const noexcept {}
+};
+Sleep sleepFor(uint32_t ms);
+Sleep sleepUntil(uint64_t timeUs);
+
+// co_await yield(): let the loop handle pending events, then carry on
+struct Yield {
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle) noexcept;
+    void await_resume() const noexcept {}
+};
+Yield yield();
+
+// co_await until(ready, context, pollMs): resume once ready(context) returns
+// true, checking every pollMs
+using Condition = bool (*)(void* context);
+struct Until {
+    Condition ready;
+    void* context;
+    uint32_t pollUs;
+    bool await_ready() const noexcept { return ready(context); }
+    bool await_suspend(std::coroutine_handle<> handle) noexcept;
+    void await_resume() const noexcept {}
+};
+Until until(Condition ready, void* context, uint32_t pollMs);
+
+// Signalled from an interrupt (or anywhere) when an operation finishes; one
+// task at a time may co_await it
+class Completion {
+public:
+    Completion() : done(false) {}
+
+    // Mark the operation finished and wake the loop (IRQ-safe)
+    void signal();
+
+    // Arm for the next operation
+    void reset() { done = false; }
+
+    bool isDone() const { return done; }
+
+    bool await_ready() const noexcept { return done; }
+    bool await_suspend(std::coroutine_handle<> handle) noexcept;
+    void await_resume() const noexcept {}
+
+private:
+    volatile bool done;
+};
+
+}  // namespace task
@@ -7,12 +7,22 @@
 
 namespace timer {
 
+// A tick moved by setNextAt() is at least this far ahead
+constexpr int64_t MIN_DELAY_US = 100;
+
 // Timer state
 static repeating_timer_t repeatingTimer;
 static bool timerRunning = false;
+static uint32_t timerIntervalMs = 250;
+static volatile uint64_t lastTickUs = 0;
 
 // Timer callback - called from IRQ context
 static bool timerCallback(repeating_timer_t *rt) {
+    lastTickUs = time_us_64();
+
+    // After a tick moved by setNextAt(), go back to the interval
+    rt->delay_us = -static_cast<int64_t>(timerIntervalMs) * 1000;
+
     // Queue a timer event
     event::queueEventFromISR(event::Event(event::EventType::Timer));
     return true;  // Keep repeating
@@ -26,6 +36,7 @@ void initTimer(uint32_t intervalMs) {
     
     // Start repeating timer (negative interval = delay between callbacks)
     // Positive interval = interval from start of callback to start of next
+    timerIntervalMs = intervalMs;
     timerRunning = add_repeating_timer_ms(-(int32_t)intervalMs, timerCallback, nullptr, &repeatingTimer);
 }
 
@@ -49,4 +60,18 @@ void setInterval(uint32_t intervalMs) {
     initTimer(intervalMs);
 }
 
+void setNextAt(uint64_t timeUs) {
+    if (!timerRunning) {
+        return;
+    }
+    cancel_repeating_timer(&repeatingTimer);
+    int64_t delayUs = static_cast<int64_t>(timeUs - time_us_64());
+    delayUs = delayUs > MIN_DELAY_US ? delayUs : MIN_DELAY_US;
+    timerRunning = add_repeating_timer_us(-delayUs, timerCallback, nullptr, &repeatingTimer);
+}
+
+uint64_t getLastTickUs() {
+    return lastTickUs;
+}
+
 }  // namespace timer
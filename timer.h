@@ -18,4 +18,11 @@ void startTimer();
 // Change the timer interval
 void setInterval(uint32_t intervalMs);
 
+// Move the next tick to timeUs (us since boot, at least a little ahead);
+// the interval carries on from there. For locking ticks to the sensor.
+void setNextAt(uint64_t timeUs);
+
+// When the last tick fired (us since boot)
+uint64_t getLastTickUs();
+
 }  // namespace timer
@@ -0,0 +1,83 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+
+#include "verticalspeed.h"
+#include <cmath>
+
+namespace verticalspeed {
+
+// Sample periods jitter by a few hundred microseconds; gains are kept while
+// the interval stays within this fraction of the one they were worked out for
+constexpr uint64_t GAIN_TOLERANCE_DIVISOR = 64;
+
+Estimator::Estimator(double altitudeNoiseFeet, double accelerationFeetPerS2)
+    : noiseFeet(altitudeNoiseFeet), accelerationFeetPerS2(accelerationFeetPerS2) {
+    reset();
+}
+
+void Estimator::reset() {
+    lastUs = 0;
+    altitude = 0.0;
+    rateFeetPerSecond = 0.0;
+    count = 0;
+    gainIntervalUs = 0;
+    alpha = 1.0;
+    beta = 0.0;
+}
+
+// Steady-state gains (Kalata) for tracking index
+//     L = sigma_a * T^2 / sigma_n
+// with r = (4 + L - sqrt(L^2 + 8L)) / 4, alpha = 1 - r^2, beta = 2(1 - r)^2.
+// r is worked out as 1 - 2L / (L + sqrt(L^2 + 8L)), which is the same value
+// without the cancellation the first form suffers once L is large.
+void Estimator::updateGains(uint64_t intervalUs) {
+    uint64_t difference = intervalUs > gainIntervalUs ? intervalUs - gainIntervalUs : gainIntervalUs - intervalUs;
+    if (gainIntervalUs != 0 && difference <= gainIntervalUs / GAIN_TOLERANCE_DIVISOR) {
+        return;
+    }
+    gainIntervalUs = intervalUs;
+
+    double seconds = intervalUs * 1e-6;
+    double index = accelerationFeetPerS2 * seconds * seconds / noiseFeet;
+    double r = 1.0 - 2.0 * index / (index + sqrt(index * index + 8.0 * index));
+    alpha = 1.0 - r * r;
+    beta = 2.0 * (1.0 - r) * (1.0 - r);
+}
+
+double Estimator::update(uint64_t timeUs, double altitudeFeet, double knownFeetPerS2) {
+    if (count > 0 && (timeUs <= lastUs || timeUs - lastUs > MAX_GAP_US)) {
+        reset();
+    }
+
+    if (count == 0) {
+        altitude = altitudeFeet;
+        rateFeetPerSecond = 0.0;
+    } else {
+        uint64_t intervalUs = timeUs - lastUs;
+        updateGains(intervalUs);
+        double seconds = intervalUs * 1e-6;
+
+        // Least squares over the samples so far until that weights the
+        // newest sample less than the steady state would (the second sample
+        // gives the straight slope between the two)
+        double n = count + 1;
+        double growingBeta = 6.0 / (n * (n + 1.0));
+        double a = alpha;
+        double b = beta;
+        if (growingBeta > beta) {
+            a = 2.0 * (2.0 * n - 1.0) / (n * (n + 1.0));
+            b = growingBeta;
+        }
+
+        // Predict, then correct by the residual
+        double predicted = altitude + (rateFeetPerSecond + 0.5 * knownFeetPerS2 * seconds) * seconds;
+        double residual = altitudeFeet - predicted;
+        altitude = predicted + a * residual;
+        rateFeetPerSecond += knownFeetPerS2 * seconds + b / seconds * residual;
+    }
+
+    lastUs = timeUs;
+    count++;
+    return getFeetPerMinute();
+}
+
+}  // namespace verticalspeed
@@ -0,0 +1,67 @@
+// (C) Alan Ludwig 2026, all rights reserved.
+#pragma once
+
+#include <cstdint>
+
+// Vertical speed from timestamped altitude samples. An alpha-beta filter
+// tracks altitude and its rate; its gains are the steady-state Kalman gains
+// for the interval since the previous sample, so the response is the same
+// whatever the sample period and a late sample is weighted for the time it
+// covers. Intervals come from integer microsecond timestamps, never from
+// differences of large floating point times. No SDK dependencies.
+namespace verticalspeed {
+
+// Noise of one altitude sample, and the vertical acceleration the filter is
+// expected to follow (1 sigma). Set from replayed flights with
+// pico-altimeter-replay --vsi-report at the rates the firmware feeds it (the
+// sensor's data rate): every 80 ms (Standard) that gives about 6 ft/min RMS
+// in level flight, every 20 ms (HighRate) about 3 ft/min, both with a delay
+// of about 1 s. The gains follow the interval, so the delay is the same at
+// any rate and the noise falls with its square root.
+constexpr double ALTITUDE_NOISE_FEET = 0.5;
+constexpr double ACCELERATION_FEET_PER_S2 = 1.0;
+
+// A gap longer than this starts the estimate again
+constexpr uint64_t MAX_GAP_US = 2000000;
+
+class Estimator {
+public:
+    Estimator(double altitudeNoiseFeet = ALTITUDE_NOISE_FEET,
+              double accelerationFeetPerS2 = ACCELERATION_FEET_PER_S2);
+
+    // Forget the history
+    void reset();
+
+    // Add the altitude measured at timeUs. Returns the vertical speed in
+    // feet per minute (0 until there are two samples; the first few are a
+    // least squares fit, so the estimate is usable from the second).
+    // A known acceleration (gravity while coasting) goes into the prediction,
+    // so following it costs no lag.
+    double update(uint64_t timeUs, double altitudeFeet, double knownFeetPerS2 = 0.0);
+
+    double getFeetPerMinute() const { return rateFeetPerSecond * 60.0; }
+
+    // Filtered altitude at the last sample
+    double getAltitudeFeet() const { return altitude; }
+
+    // Samples since the last reset
+    uint32_t getCount() const { return count; }
+
+private:
+    void updateGains(uint64_t intervalUs);
+
+    double noiseFeet;
+    double accelerationFeetPerS2;
+
+    uint64_t lastUs;
+    double altitude;
+    double rateFeetPerSecond;
+    uint32_t count;
+
+    // Gains for gainIntervalUs; recomputed only when the interval changes
+    uint64_t gainIntervalUs;
+    double alpha;
+    double beta;
+};
+
+}  // namespace verticalspeed